@@ -2,11 +2,17 @@
   "targets": [
     {
       "sources": [
+        "src/AsyncIO.cpp",
         "src/Group.cpp",
         "src/File.cpp",
         "src/Variable.cpp",
         "src/Dimension.cpp",
         "src/Attribute.cpp",
+        "src/ChunkIterator.cpp",
+        "src/MappedFile.cpp",
+        "src/Metadata.cpp",
+        "src/UserType.cpp",
+        "src/WrapperCache.cpp",
         "src/nodenetcdfjs.cpp"
       ],
       "target_name": "nodenetcdf",
@@ -2,6 +2,8 @@
 // Project: https://github.com/pheonixfirewingz/netcdf4
 // Definitions by: Luke Shore <luke.a.shore@oliva.energy>
 
+import type { Readable, Writable } from 'stream';
+
 /**
  * NetCDF data types
  */
@@ -16,6 +18,7 @@ export type NetCDFDataType =
   | 'ushort'
   | 'uint'
   | 'int64'
+  | 'uint64'
   | 'string';
 
 /**
@@ -33,6 +36,7 @@ export type FileMode =
 export type FileFormat = 
   | 'classic'           // Classic NetCDF format
   | 'classic64'         // 64-bit offset format
+  | 'cdf5'              // 64-bit data format (CDF5)
   | 'nodenetcdf'        // NetCDF-4 format
   | 'nodenetcdfclassic'; // NetCDF-4 classic model
 
@@ -56,6 +60,120 @@ export type ChunkMode = 'contiguous' | 'chunked';
  */
 export type FillMode = 'fill' | 'nofill';
 
+/**
+ * HDF5 chunk cache settings
+ */
+export interface ChunkCache {
+  /** Cache size in bytes */
+  size: number;
+  /** Number of hash table slots, ideally a prime */
+  nelems: number;
+  /** Preemption policy between 0 and 1; 1 evicts fully read chunks first */
+  preemption: number;
+}
+
+/**
+ * Options accepted when opening or creating a file
+ */
+export interface FileOptions {
+  /** Chunk cache given to every variable of the file */
+  chunkCache?: Partial<ChunkCache>;
+  /** Create the file in memory ('c'/'c!' only); close() returns its bytes */
+  inMemory?: boolean;
+  /** Initial size in bytes of an inMemory file */
+  initialSize?: number;
+  /** Load the whole file into memory when opening ('r' only); the file is not read again */
+  diskless?: boolean;
+  /**
+   * Decompress every chunk on open into caches sized so nothing is ever evicted ('r' only).
+   * Pinned caches total at most maxBytes (default 1 GiB); variables that no longer fit keep
+   * their default cache
+   */
+  decompressOnOpen?: boolean | { maxBytes?: number };
+  /**
+   * Memory-map a classic, 64-bit offset or CDF5 file ('r' only). Contiguous readSlice()
+   * results then come straight from the mapping, byte and char data through pages mapped
+   * privately for each array; writes to them never reach the file or other results
+   */
+  mmap?: boolean;
+}
+
+/**
+ * Attribute in a File.describe() snapshot; 64-bit integers are decimal strings
+ */
+export interface AttributeDescription {
+  name: string;
+  value: number | string | (number | string)[] | null;
+}
+
+/**
+ * Dimension in a File.describe() snapshot; unlimited is only set on a group's own dimensions
+ */
+export interface DimensionDescription {
+  id: number;
+  name: string;
+  /** Length on disk, as dimension.length reports it */
+  length: number;
+  /** Length including records buffered by appendRecords(), only set when longer */
+  bufferedLength?: number;
+  unlimited?: boolean;
+}
+
+/**
+ * Variable in a File.describe() snapshot; storage settings the format lacks are left out
+ */
+export interface VariableDescription {
+  id: number;
+  name: string;
+  type: NetCDFDataType | string;
+  dimensions: DimensionDescription[];
+  attributes: AttributeDescription[];
+  endianness?: string;
+  checksummode?: ChecksumMode;
+  chunkmode?: 'contiguous' | 'chunked' | 'compact';
+  chunksizes?: number[];
+  fillmode?: boolean;
+  fillvalue?: number | string | null;
+  compressionshuffle?: boolean;
+  compressiondeflate?: boolean;
+  compressionlevel?: number;
+}
+
+/**
+ * Group in a File.describe() snapshot
+ */
+export interface GroupDescription {
+  id: number;
+  name: string;
+  fullname: string;
+  dimensions: DimensionDescription[];
+  variables: VariableDescription[];
+  attributes: AttributeDescription[];
+  subgroups: GroupDescription[];
+}
+
+/**
+ * Options for slice reads
+ */
+export interface ReadOptions {
+  /**
+   * Numeric type of the returned typed array; values are converted by the NetCDF library while reading
+   */
+  outputType?: Exclude<NetCDFDataType, 'string'>;
+
+  /**
+   * Apply the CF scale_factor/add_offset attributes; returns a Float32Array (Float64Array for double and 64-bit integer variables)
+   * unless outputType is 'double' or 'float'
+   */
+  unpack?: boolean;
+
+  /**
+   * true: replace _FillValue/missing_value matches with NaN (float or double output only);
+   * 'bitmap': return { values, validity } with one LSB-first validity bit per value instead
+   */
+  mask?: boolean | 'bitmap';
+}
+
 /**
  * Represents a NetCDF attribute
  */
@@ -126,9 +244,9 @@ export class Variable {
   readonly id: number;
 
   /**
-   * The data type of the variable
+   * The data type of the variable, or the name of its user-defined type
    */
-  readonly type: NetCDFDataType;
+  readonly type: NetCDFDataType | string;
 
   /**
    * The dimensions of the variable
@@ -165,6 +283,14 @@ export class Variable {
    */
   chunkSizes: number[];
 
+  /**
+   * The HDF5 chunk cache of this variable. Assign { size, nelems, preemption }, or
+   * { access, maxSize?, preemption? } to size it for reads of the given per-dimension extent
+   * (e.g. [nt, 1, 1] for point time series) up to maxSize bytes (default 256 MiB)
+   */
+  get chunkCache(): ChunkCache;
+  set chunkCache(value: Partial<ChunkCache> | { access: number[]; maxSize?: number; preemption?: number });
+
   /**
    * The fill mode
    */
@@ -199,16 +325,31 @@ export class Variable {
    * Read a slice of the variable
    * @param start - Starting indices for each dimension
    * @param count - Number of elements to read in each dimension
+   * @param options - outputType: convert to this type while reading (e.g. 'float' returns a Float32Array);
+   *   unpack: apply scale_factor/add_offset; mask: handle missing values.
+   *   User-defined types are read as columns (options are not supported): compounds give one column
+   *   per member, VLENs { values, offsets }, enums their base type, opaques a Uint8Array
    */
-  readSlice(start: number[], count: number[]): any;
+  readSlice(start: number[], count: number[], options?: ReadOptions): any;
+
+  /**
+   * Read the strings of a string or char variable in Apache Arrow's utf8 layout
+   * @param start - Starting indices; for char variables every dimension but the last (the characters)
+   * @param count - Number of strings in each of those dimensions
+   * @returns The UTF-8 bytes back to back, and count + 1 offsets: string i is data[offsets[i]..offsets[i + 1]).
+   *   Char rows end at their first NUL and trailing blanks are trimmed
+   */
+  readStrings(start: number[], count: number[]): { data: Uint8Array; offsets: Int32Array };
 
   /**
    * Read a strided slice of the variable
    * @param start - Starting indices for each dimension
    * @param count - Number of elements to read in each dimension
    * @param stride - Stride for each dimension
+   * @param options - outputType: convert to this type while reading; unpack: apply scale_factor/add_offset;
+   *   mask: handle missing values
    */
-  readStridedSlice(start: number[], count: number[], stride: number[]): any;
+  readStridedSlice(start: number[], count: number[], stride: number[], options?: ReadOptions): any;
 
   /**
    * Write data to the entire variable
@@ -233,6 +374,144 @@ export class Variable {
    */
   writeStridedSlice(start: number[], count: number[], stride: number[], data: any): void;
 
+  /**
+   * Read a slice of the variable into an existing typed array without allocating
+   * @param start - Starting indices for each dimension
+   * @param count - Number of elements to read in each dimension
+   * @param target - Typed array matching the variable type
+   * @param byteOffset - Byte offset into the target (default 0)
+   * @returns The target array
+   */
+  readSliceInto<T extends ArrayBufferView>(start: number[], count: number[], target: T, byteOffset?: number): T;
+
+  /**
+   * Read a strided slice of the variable into an existing typed array without allocating
+   * @param start - Starting indices for each dimension
+   * @param count - Number of elements to read in each dimension
+   * @param stride - Stride for each dimension
+   * @param target - Typed array matching the variable type
+   * @param byteOffset - Byte offset into the target (default 0)
+   * @returns The target array
+   */
+  readStridedSliceInto<T extends ArrayBufferView>(start: number[], count: number[], stride: number[], target: T,
+    byteOffset?: number): T;
+
+  /**
+   * Read values at scattered points; each touched chunk is read once
+   * @param coords - Flat array of npoints x ndims indices
+   * @returns Typed array of npoints values, in the order of the coordinates
+   */
+  readPoints(coords: Int32Array | Uint32Array | BigInt64Array | BigUint64Array): any;
+
+  /**
+   * Write values at scattered points; each touched chunk is rewritten once
+   * @param coords - Flat array of npoints x ndims indices
+   * @param values - Typed array matching the variable type, one value per point
+   */
+  writePoints(coords: Int32Array | Uint32Array | BigInt64Array | BigUint64Array, values: any): void;
+
+  /**
+   * Append records along the leading unlimited dimension; records are buffered natively
+   * until they fill a storage chunk along that dimension, the rest is written by
+   * File.sync() and File.close(). Each variable starts at the length the dimension had
+   * when appending along it began and continues after its own records, so variables
+   * sharing the dimension stay aligned whatever their chunk sizes; once the dimension has
+   * grown by other writes, appends start at its new end. If a write fails, the
+   * buffered records are dropped and the error is thrown, so a retry does not repeat them
+   * @param values - Typed array matching the variable type holding whole records
+   */
+  appendRecords(values: any): void;
+
+  /**
+   * Object-mode writable stream passing each written typed array to appendRecords();
+   * ending the stream writes the records still buffered for this variable
+   * @returns Writable stream of typed arrays holding whole records
+   */
+  createAppendStream(): Writable;
+
+  /**
+   * Compute statistics over a hyperslab chunk by chunk, skipping NaN, _FillValue and missing_value
+   * @param options - start/count select the slice (default: whole variable); ops selects the statistics
+   *   (default: all); axes lists the dimensions to reduce (default: all); unpack applies scale_factor/add_offset
+   * @returns One Float64Array per requested op, shaped by the non-reduced dimensions
+   */
+  reduce(options?: {
+    start?: number[];
+    count?: number[];
+    ops?: ('min' | 'max' | 'sum' | 'mean' | 'count')[];
+    axes?: number[];
+    unpack?: boolean;
+  }): {
+    shape: number[];
+    min?: Float64Array;
+    max?: Float64Array;
+    sum?: Float64Array;
+    mean?: Float64Array;
+    count?: Float64Array;
+  };
+
+  /**
+   * Walk a hyperslab in blocks aligned to the storage chunk grid; the next block is read
+   * on the I/O thread while the current one is processed
+   * @param options - start/count select the slice (default: whole variable); maxBytes caps the
+   *   block size (default: 4 MiB, but a single storage chunk is never split)
+   * @returns Async iterator usable in for await...of
+   */
+  chunks(options?: {
+    start?: number[];
+    count?: number[];
+    maxBytes?: number;
+  }): AsyncIterableIterator<{ start: number[]; count: number[]; data: any }>;
+
+  /**
+   * Stream the raw bytes of a hyperslab in C order; blocks are read ahead on the
+   * I/O thread and reading pauses while the consumer applies backpressure
+   * @param options - start/count select the slice (default: whole variable); highWaterMark is
+   *   the stream buffer and approximate block size in bytes (default: 4 MiB)
+   * @returns Readable stream of Buffers
+   */
+  createReadStream(options?: {
+    start?: number[];
+    count?: number[];
+    highWaterMark?: number;
+  }): Readable;
+
+  /**
+   * Read a slice of the variable on the I/O thread. While the read runs, synchronous
+   * calls that reach netCDF (readSlice(), uncached properties) wait for it; cached
+   * properties such as name, dimensions and attributes do not
+   * @param start - Starting indices for each dimension
+   * @param count - Number of elements to read in each dimension
+   * @returns Promise resolving to a typed array matching the variable type
+   */
+  readSliceAsync(start: number[], count: number[]): Promise<any>;
+
+  /**
+   * Read a strided slice of the variable on the I/O thread
+   * @param start - Starting indices for each dimension
+   * @param count - Number of elements to read in each dimension
+   * @param stride - Stride for each dimension
+   * @returns Promise resolving to a typed array matching the variable type
+   */
+  readStridedSliceAsync(start: number[], count: number[], stride: number[]): Promise<any>;
+
+  /**
+   * Write a slice of the variable on the I/O thread
+   * @param start - Starting indices for each dimension
+   * @param count - Number of elements to write in each dimension
+   * @param data - Typed array matching the variable type; must not be modified until the promise settles
+   */
+  writeSliceAsync(start: number[], count: number[], data: any): Promise<void>;
+
+  /**
+   * Write a strided slice of the variable on the I/O thread
+   * @param start - Starting indices for each dimension
+   * @param count - Number of elements to write in each dimension
+   * @param stride - Stride for each dimension
+   * @param data - Typed array matching the variable type; must not be modified until the promise settles
+   */
+  writeStridedSliceAsync(start: number[], count: number[], stride: number[], data: any): Promise<void>;
+
   /**
    * Add an attribute to the variable
    * @param name - Attribute name
@@ -331,6 +610,30 @@ export class Group {
    */
   addVariable(name: string, type: NetCDFDataType, dimensions: (string | Dimension)[]): Variable;
 
+  /**
+   * Read several hyperslabs in one native call, ordered for locality
+   * @param slices - Slice descriptors; variable may be a Variable or the name of a variable in this group
+   * @param options - pack: return views into one shared ArrayBuffer at 8-byte aligned offsets
+   * @returns One typed array per descriptor, in descriptor order
+   */
+  readSlices(
+    slices: { variable: Variable | string; start: number[]; count: number[]; stride?: number[] }[],
+    options?: { pack?: boolean }
+  ): any[];
+
+  /**
+   * Get one variable of the group by name without building the variables map
+   * @returns The variable, or undefined if the group has none of that name
+   */
+  getVariable(name: string): Variable | undefined;
+
+  /**
+   * Get a variable or group by path, creating only the returned wrapper
+   * @param path - Relative to this group, or absolute from the root; variables win over groups of the same name
+   * @returns The variable or group, or undefined if nothing matches the path
+   */
+  get(path: string): Variable | Group | undefined;
+
   /**
    * Inspect the group
    */
@@ -361,11 +664,15 @@ export class File {
 
   /**
    * Open or create a NetCDF file
-   * @param filename - Path to the file
+   * @param filename - Path to the file, or a Buffer/ArrayBuffer holding a file image to open
+   *   read-only without copying; the memory is kept alive until the file is closed
    * @param mode - File mode ('r', 'w', 'c', 'c!')
    * @param format - File format (optional, defaults to 'nodenetcdf')
+   * @param options - Open options such as the chunk cache
    */
-  constructor(filename: string, mode: FileMode, format?: FileFormat);
+  constructor(filename: string | ArrayBufferView | ArrayBuffer, mode: FileMode, format?: FileFormat,
+    options?: FileOptions);
+  constructor(filename: string | ArrayBufferView | ArrayBuffer, mode: FileMode, options: FileOptions);
 
   /**
    * Synchronize the file to disk
@@ -373,9 +680,11 @@ export class File {
   sync(): void;
 
   /**
-   * Close the file
+   * Close the file. Throws while asynchronous reads or writes, including the block a
+   * chunks() iterator is reading, are still running on it; await them first
+   * @returns The file image for files created with the inMemory option, otherwise undefined
    */
-  close(): void;
+  close(): Buffer | undefined;
 
   /**
    * Inspect the file
@@ -386,4 +695,17 @@ export class File {
    * Convert the file to a JSON-serializable object (serializes the entire file structure via root group)
    */
   toJSON(): any;
+
+  /**
+   * Describe the whole file natively in one call, without creating wrapper objects
+   * @param options - json: return the snapshot as a JSON string
+   */
+  describe(options?: { json?: false }): GroupDescription;
+  describe(options: { json: true }): string;
+
+  /**
+   * Get a variable or group by path from the root, e.g. '/forecast/ens03/u10', creating only the returned wrapper
+   * @returns The variable or group, or undefined if nothing matches the path
+   */
+  get(path: string): Variable | Group | undefined;
 }
@@ -0,0 +1,267 @@
+#include "AsyncIO.h"
+#include "nodenetcdfjs.h"
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <uv.h>
+
+namespace nodenetcdfjs
+{
+
+namespace
+{
+/// Guards the registry, which chunk iterators also use outside netcdf_mutex()
+std::mutex registry_mutex;
+
+/// Completions waiting to run on the event loop of one isolate
+struct Channel
+{
+    /// Wakes the event loop when completions are ready
+    uv_async_t async{};
+
+    /// Closes async when the environment is torn down
+    node::AsyncCleanupHookHandle hook;
+
+    /// Guards done and closed, which the I/O thread also uses
+    std::mutex mutex;
+
+    /// Completions whose work has returned
+    std::deque<std::function<void()>> done;
+
+    /// Whether the environment is gone
+    bool closed{false};
+
+    /// Operations queued and not yet completed; async is referenced while nonzero (JavaScript thread only)
+    size_t pending{0};
+};
+
+/// An operation waiting for the I/O thread
+struct Job
+{
+    std::shared_ptr<Channel> channel;
+    std::function<void()> work;
+    std::function<void()> after;
+};
+
+/// Queue of the I/O thread
+struct Worker
+{
+    std::mutex mutex;
+    std::condition_variable ready;
+    std::deque<Job> jobs;
+    bool started{false};
+};
+
+/// Deliberately leaked: the detached I/O thread may still wait on it during static destruction
+Worker &worker() noexcept
+{
+    static auto *state = new Worker();
+    return *state;
+}
+
+/// Channels by isolate, guarded by registry_mutex
+std::unordered_map<v8::Isolate *, std::shared_ptr<Channel>> &channels() noexcept
+{
+    static std::unordered_map<v8::Isolate *, std::shared_ptr<Channel>> channels;
+    return channels;
+}
+
+/**
+ * @brief Body of the I/O thread: run queued work in order, then post each completion
+ */
+void run_jobs()
+{
+    Worker &state = worker();
+    for (;;)
+    {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(state.mutex);
+            state.ready.wait(lock, [&state] { return !state.jobs.empty(); });
+            job = std::move(state.jobs.front());
+            state.jobs.pop_front();
+        }
+        {
+            const std::lock_guard<std::recursive_mutex> lock(netcdf_mutex());
+            job.work();
+        }
+        const std::lock_guard<std::mutex> lock(job.channel->mutex);
+        if (job.channel->closed)
+        {
+            // The completion holds V8 handles of an isolate that is gone, so it cannot even be destroyed
+            (void)new std::function<void()>(std::move(job.after));
+            continue;
+        }
+        job.channel->done.push_back(std::move(job.after));
+        uv_async_send(&job.channel->async);
+    }
+}
+
+/**
+ * @brief Run the completions posted to a channel, on its event loop
+ */
+void run_completions(uv_async_t *async)
+{
+    auto *channel = static_cast<Channel *>(async->data);
+    std::deque<std::function<void()>> done;
+    {
+        const std::lock_guard<std::mutex> lock(channel->mutex);
+        done.swap(channel->done);
+    }
+    for (std::function<void()> &after : done)
+    {
+        after();
+        if (--channel->pending == 0)
+            uv_unref(reinterpret_cast<uv_handle_t *>(&channel->async));
+    }
+}
+
+/**
+ * @brief Environment cleanup hook closing the channel of an isolate
+ */
+void close_channel(void *arg, void (*finished)(void *), void *finished_arg)
+{
+    std::shared_ptr<Channel> channel;
+    {
+        const std::lock_guard<std::mutex> lock(registry_mutex);
+        auto it = channels().find(static_cast<v8::Isolate *>(arg));
+        channel = std::move(it->second);
+        channels().erase(it);
+    }
+    {
+        const std::lock_guard<std::mutex> lock(channel->mutex);
+        channel->closed = true;
+        // Released while the isolate still exists
+        channel->done.clear();
+    }
+    struct Closing
+    {
+        std::shared_ptr<Channel> channel;
+        void (*finished)(void *);
+        void *finished_arg;
+    };
+    channel->async.data = new Closing{channel, finished, finished_arg};
+    uv_close(reinterpret_cast<uv_handle_t *>(&channel->async), [](uv_handle_t *handle) {
+        const std::unique_ptr<Closing> closing(static_cast<Closing *>(handle->data));
+        closing->finished(closing->finished_arg);
+    });
+}
+
+/**
+ * @brief Get the channel of an isolate, creating it on first use
+ */
+std::shared_ptr<Channel> channel_of(v8::Isolate *isolate)
+{
+    {
+        const std::lock_guard<std::mutex> lock(registry_mutex);
+        if (auto it = channels().find(isolate); it != channels().end())
+            return it->second;
+    }
+    auto channel = std::make_shared<Channel>();
+    uv_async_init(node::GetCurrentEventLoop(isolate), &channel->async, run_completions);
+    channel->async.data = channel.get();
+    uv_unref(reinterpret_cast<uv_handle_t *>(&channel->async));
+    channel->hook = node::AddEnvironmentCleanupHook(isolate, close_channel, isolate);
+    const std::lock_guard<std::mutex> lock(registry_mutex);
+    channels()[isolate] = channel;
+    return channel;
+}
+} // namespace
+
+std::unordered_map<int, AsyncIO::File> &AsyncIO::files() noexcept
+{
+    static std::unordered_map<int, File> files;
+    return files;
+}
+
+void AsyncIO::open(int ncid)
+{
+    const int root = file_of(ncid);
+    const std::lock_guard<std::mutex> lock(registry_mutex);
+    static uint64_t sessions = 0;
+    File &file = files()[root];
+    file = File{};
+    file.session = ++sessions;
+}
+
+uint64_t AsyncIO::session(int ncid)
+{
+    const int root = file_of(ncid);
+    const std::lock_guard<std::mutex> lock(registry_mutex);
+    const auto it = files().find(root);
+    return it == files().end() || it->second.closer ? 0 : it->second.session;
+}
+
+bool AsyncIO::begin(int ncid, uint64_t session)
+{
+    const int root = file_of(ncid);
+    const std::lock_guard<std::mutex> lock(registry_mutex);
+    const auto it = files().find(root);
+    if (session == 0 || it == files().end() || it->second.session != session || it->second.closer)
+        return false;
+    it->second.pending++;
+    return true;
+}
+
+void AsyncIO::end(int ncid)
+{
+    const int root = file_of(ncid);
+    std::function<void()> closer;
+    {
+        const std::lock_guard<std::mutex> lock(registry_mutex);
+        const auto it = files().find(root);
+        if (it == files().end() || --it->second.pending > 0 || !it->second.closer)
+            return;
+        closer = std::move(it->second.closer);
+        files().erase(it);
+    }
+    closer();
+}
+
+size_t AsyncIO::pending(int ncid)
+{
+    const int root = file_of(ncid);
+    const std::lock_guard<std::mutex> lock(registry_mutex);
+    const auto it = files().find(root);
+    return it == files().end() ? 0 : it->second.pending;
+}
+
+void AsyncIO::close(int ncid, std::function<void()> closer)
+{
+    const int root = file_of(ncid);
+    {
+        const std::lock_guard<std::mutex> lock(registry_mutex);
+        const auto it = files().find(root);
+        if (it != files().end() && it->second.pending > 0)
+        {
+            it->second.closer = std::move(closer);
+            return;
+        }
+        if (it != files().end())
+            files().erase(it);
+    }
+    closer();
+}
+
+void AsyncIO::queue(v8::Isolate *isolate, std::function<void()> work, std::function<void()> after)
+{
+    std::shared_ptr<Channel> channel = channel_of(isolate);
+    if (channel->pending++ == 0)
+        uv_ref(reinterpret_cast<uv_handle_t *>(&channel->async));
+    Worker &state = worker();
+    {
+        const std::lock_guard<std::mutex> lock(state.mutex);
+        state.jobs.push_back(Job{std::move(channel), std::move(work), std::move(after)});
+        if (!state.started)
+        {
+            state.started = true;
+            std::thread(run_jobs).detach();
+        }
+    }
+    state.ready.notify_one();
+}
+
+} // namespace nodenetcdfjs
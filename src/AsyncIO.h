@@ -0,0 +1,112 @@
+#ifndef NODENETCDFJS_ASYNCIO_H
+#define NODENETCDFJS_ASYNCIO_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <node.h>
+#include <unordered_map>
+
+namespace nodenetcdfjs
+{
+
+/**
+ * @brief Bookkeeping of the asynchronous operations running on each open file
+ *
+ * Promise-based slice reads and writes and the blocks of Variable.chunks() use an ncid
+ * after the call that queued them has returned. Every such operation is counted against
+ * its file from the moment it is queued until its completion has run on the JavaScript
+ * thread, so a file is never closed under a running operation:
+ * - File.close() refuses to close while operations are counted,
+ * - a File collected by the garbage collector defers its close until the last one ends.
+ *
+ * Each open file also gets a session number. NetCDF reuses the ncid of a closed file,
+ * so objects that queue work long after they were created (chunk iterators) keep the
+ * session of their file and cannot start operations on another file opened later.
+ *
+ * The NetCDF calls of these operations all run on one dedicated I/O thread, in queueing
+ * order, rather than on the libuv thread pool: the library is serialised by
+ * netcdf_mutex() anyway, and pool threads blocked on that lock would hold up file system
+ * and DNS work of the whole process. Completions are handed back to the event loop of
+ * the isolate that queued them.
+ */
+class AsyncIO
+{
+  public:
+    AsyncIO() = delete;
+
+    /**
+     * @brief Register a file that has just been opened or created
+     * @param ncid ID of the file
+     */
+    static void open(int ncid);
+
+    /**
+     * @brief Get the session of an open file
+     * @param ncid Group or file ID
+     * @return The session, or 0 if the file is not open
+     */
+    [[nodiscard]] static uint64_t session(int ncid);
+
+    /**
+     * @brief Count an operation before it is queued
+     * @param ncid Group or file ID the operation uses
+     * @param session Session of the file, see session()
+     * @return Whether the file of that session is still open; otherwise nothing was counted
+     */
+    [[nodiscard]] static bool begin(int ncid, uint64_t session);
+
+    /**
+     * @brief Finish an operation counted by begin(), after its completion has run
+     * @param ncid Group or file ID the operation used
+     *
+     * Runs the deferred close of the file when this was its last operation.
+     */
+    static void end(int ncid);
+
+    /**
+     * @brief Get the number of operations running on a file
+     * @param ncid Group or file ID
+     */
+    [[nodiscard]] static size_t pending(int ncid);
+
+    /**
+     * @brief Forget a file that is about to be closed
+     * @param ncid Group or file ID
+     * @param closer Closes the file; called now if no operation is running, otherwise by
+     *        the end() of the last one. New operations cannot begin in the meantime.
+     */
+    static void close(int ncid, std::function<void()> closer);
+
+    /**
+     * @brief Run NetCDF work on the I/O thread, then its completion on the JavaScript thread
+     * @param isolate The isolate whose event loop runs the completion
+     * @param work Runs on the I/O thread while holding netcdf_mutex(); must not touch V8
+     * @param after Runs on the JavaScript thread once work has returned
+     *
+     * The event loop is kept alive while completions are outstanding. Completions still
+     * outstanding when the environment is torn down (e.g. a terminated worker) never run.
+     */
+    static void queue(v8::Isolate *isolate, std::function<void()> work, std::function<void()> after);
+
+  private:
+    /// State of one open file
+    struct File
+    {
+        /// Session number, unique for the lifetime of the process
+        uint64_t session{0};
+
+        /// Operations begun and not yet ended
+        size_t pending{0};
+
+        /// Deferred close, set once the file is being closed
+        std::function<void()> closer;
+    };
+
+    /// Open files, keyed by the ID of their root group, see file_of()
+    [[nodiscard]] static std::unordered_map<int, File> &files() noexcept;
+};
+
+} // namespace nodenetcdfjs
+
+#endif
@@ -1,4 +1,6 @@
 #include "Attribute.h"
+#include "Variable.h"
+#include "WrapperCache.h"
 #include "nodenetcdfjs.h"
 #include <inttypes.h>
 #include <iostream>
@@ -41,15 +43,15 @@ void Attribute::Init(v8::Local<v8::Object> exports)
     v8::Local<v8::FunctionTemplate> tpl = v8::FunctionTemplate::New(isolate);
     tpl->SetClassName(v8::String::NewFromUtf8(isolate, "Attribute", v8::NewStringType::kNormal).ToLocalChecked());
     tpl->InstanceTemplate()->SetInternalFieldCount(1);
-    NODE_SET_PROTOTYPE_METHOD(tpl, "delete", Attribute::Delete);
-    NODE_SET_PROTOTYPE_METHOD(tpl, "inspect", Attribute::Inspect);
-    NODE_SET_PROTOTYPE_METHOD(tpl, "toJSON", Attribute::ToJSON);
+    NODE_SET_PROTOTYPE_METHOD(tpl, "delete", serialized<Attribute::Delete>);
+    NODE_SET_PROTOTYPE_METHOD(tpl, "inspect", serialized<Attribute::Inspect>);
+    NODE_SET_PROTOTYPE_METHOD(tpl, "toJSON", serialized<Attribute::ToJSON>);
     tpl->InstanceTemplate()->SetAccessor(
-        v8::String::NewFromUtf8(isolate, "name", v8::NewStringType::kNormal).ToLocalChecked(), Attribute::GetName,
-        Attribute::SetName);
+        v8::String::NewFromUtf8(isolate, "name", v8::NewStringType::kNormal).ToLocalChecked(),
+        serialized<Attribute::GetName>, serialized<Attribute::SetName>);
     tpl->InstanceTemplate()->SetAccessor(
-        v8::String::NewFromUtf8(isolate, "value", v8::NewStringType::kNormal).ToLocalChecked(), Attribute::GetValue,
-        Attribute::SetValue);
+        v8::String::NewFromUtf8(isolate, "value", v8::NewStringType::kNormal).ToLocalChecked(),
+        serialized<Attribute::GetValue>, serialized<Attribute::SetValue>);
     constructor.Reset(isolate, tpl->GetFunction(isolate->GetCurrentContext()).ToLocalChecked());
 }
 
@@ -75,7 +77,11 @@ void Attribute::SetName(v8::Local<v8::String> property, v8::Local<v8::Value> val
         throw_netcdf_error(isolate, retval);
         return;
     }
+    WrapperCache::erase(WrapperCache::Kind::Attribute, obj->parent_id, obj->var_id, obj->name);
     obj->name = *new_name_;
+    WrapperCache::set(isolate, WrapperCache::Kind::Attribute, obj->parent_id, obj->var_id, obj->name, info.Holder());
+    WrapperCache::erase(WrapperCache::Kind::Attributes, obj->parent_id, obj->var_id);
+    Variable::attributes_changed(isolate, obj->parent_id, obj->var_id);
 }
 
 void Attribute::GetValue(v8::Local<v8::String> property, const v8::PropertyCallbackInfo<v8::Value> &info)
@@ -205,30 +211,20 @@ void Attribute::GetValue(v8::Local<v8::String> property, const v8::PropertyCallb
         }
     }
     break;
-    case NC_INT64: {
-        std::vector<int64_t> v(len);
-        retval = nc_get_att(obj->parent_id, obj->var_id, obj->name.c_str(), v.data());
-        if (len == 1)
-            info.GetReturnValue().Set(v8::Integer::New(isolate, static_cast<int32_t>(v[0])));
-        else
-        {
-            v8::Local<v8::ArrayBuffer> buffer = v8::ArrayBuffer::New(isolate, len * sizeof(int64_t));
-            memcpy(buffer->GetBackingStore()->Data(), v.data(), len * sizeof(int64_t));
-            info.GetReturnValue().Set(v8::Int32Array::New(buffer, 0, len));
-        }
-    }
-    break;
+    case NC_INT64:
     case NC_UINT64: {
-        std::vector<uint64_t> v(len);
-        retval = nc_get_att(obj->parent_id, obj->var_id, obj->name.c_str(), v.data());
-        if (len == 1)
-            info.GetReturnValue().Set(v8::Integer::NewFromUnsigned(isolate, static_cast<uint32_t>(v[0])));
+        // Read straight into the array; a single value becomes a BigInt
+        v8::Local<v8::ArrayBuffer> buffer = v8::ArrayBuffer::New(isolate, len * sizeof(int64_t));
+        retval = nc_get_att(obj->parent_id, obj->var_id, obj->name.c_str(), buffer->Data());
+        if (len == 1 && obj->type == NC_INT64)
+            info.GetReturnValue().Set(v8::BigInt::New(isolate, *static_cast<const int64_t *>(buffer->Data())));
+        else if (len == 1)
+            info.GetReturnValue().Set(
+                v8::BigInt::NewFromUnsigned(isolate, *static_cast<const uint64_t *>(buffer->Data())));
+        else if (obj->type == NC_INT64)
+            info.GetReturnValue().Set(v8::BigInt64Array::New(buffer, 0, len));
         else
-        {
-            v8::Local<v8::ArrayBuffer> buffer = v8::ArrayBuffer::New(isolate, len * sizeof(uint64_t));
-            memcpy(buffer->GetBackingStore()->Data(), v.data(), len * sizeof(uint64_t));
-            info.GetReturnValue().Set(v8::Uint32Array::New(buffer, 0, len));
-        }
+            info.GetReturnValue().Set(v8::BigUint64Array::New(buffer, 0, len));
     }
     break;
     case NC_CHAR:
@@ -254,7 +250,7 @@ void Attribute::SetValue(v8::Local<v8::String> property, v8::Local<v8::Value> va
 void Attribute::set_value(const v8::Local<v8::Value> &val)
 {
     v8::Isolate *isolate = v8::Isolate::GetCurrent();
-    if ((type < NC_BYTE || type > NC_UINT) && type != NC_STRING)
+    if ((type < NC_BYTE || type > NC_UINT64) && type != NC_STRING)
     {
         isolate->ThrowException(v8::Exception::TypeError(
             v8::String::NewFromUtf8(isolate, "Variable type not supported yet", v8::NewStringType::kNormal)
@@ -263,7 +259,24 @@ void Attribute::set_value(const v8::Local<v8::Value> &val)
     }
 
     int retval = NC_NOERR;
-    if (val->IsUint32())
+    if (val->IsBigInt64Array() || val->IsBigUint64Array())
+    {
+        // Written from the array's memory without a copy
+        v8::Local<v8::TypedArray> array = val.As<v8::TypedArray>();
+        type = val->IsBigInt64Array() ? NC_INT64 : NC_UINT64;
+        retval = nc_put_att(parent_id, var_id, name.c_str(), type, array->Length(),
+                            static_cast<const char *>(array->Buffer()->Data()) + array->ByteOffset());
+    }
+    else if (val->IsBigInt() || ((type == NC_INT64 || type == NC_UINT64) && val->IsNumber()))
+    {
+        // 64-bit values keep a declared uint64 type; any other BigInt is stored as int64
+        if (type != NC_UINT64)
+            type = NC_INT64;
+        const int64_t v = type == NC_INT64 ? get_integer64<int64_t>(isolate, val)
+                                           : static_cast<int64_t>(get_integer64<uint64_t>(isolate, val));
+        retval = nc_put_att(parent_id, var_id, name.c_str(), type, 1, &v);
+    }
+    else if (val->IsUint32())
     {
         const uint32_t v = val->Uint32Value(isolate->GetCurrentContext()).ToChecked();
         retval = nc_put_att(parent_id, var_id, name.c_str(), NC_UINT, 1, &v);
@@ -287,6 +300,7 @@ void Attribute::set_value(const v8::Local<v8::Value> &val)
 
     if (retval != NC_NOERR)
         throw_netcdf_error(isolate, retval);
+    Variable::attributes_changed(isolate, parent_id, var_id);
 }
 
 void Attribute::Delete(const v8::FunctionCallbackInfo<v8::Value> &args)
@@ -294,7 +308,13 @@ void Attribute::Delete(const v8::FunctionCallbackInfo<v8::Value> &args)
     auto *obj = node::ObjectWrap::Unwrap<Attribute>(args.Holder());
     const int retval = nc_del_att(obj->parent_id, obj->var_id, obj->name.c_str());
     if (retval != NC_NOERR)
+    {
         throw_netcdf_error(args.GetIsolate(), retval);
+        return;
+    }
+    WrapperCache::erase(WrapperCache::Kind::Attribute, obj->parent_id, obj->var_id, obj->name);
+    WrapperCache::erase(WrapperCache::Kind::Attributes, obj->parent_id, obj->var_id);
+    Variable::attributes_changed(args.GetIsolate(), obj->parent_id, obj->var_id);
 }
 
 void Attribute::Inspect(const v8::FunctionCallbackInfo<v8::Value> &args)
@@ -338,10 +358,15 @@ void Attribute::ToJSON(const v8::FunctionCallbackInfo<v8::Value> &args)
         for (uint32_t i = 0; i < length; i++)
         {
             v8::Local<v8::Value> element = typedArray->Get(context, i).ToLocalChecked();
+            // JSON has no BigInt; 64-bit integers are kept exact as decimal strings
+            if (element->IsBigInt())
+                element = element->ToString(context).ToLocalChecked();
             (void)array->Set(context, i, element);
         }
         value = array;
     }
+    else if (value->IsBigInt())
+        value = value->ToString(context).ToLocalChecked();
 
     (void)json->CreateDataProperty(context, value_str, value);
 
@@ -0,0 +1,296 @@
+#include "ChunkIterator.h"
+#include "AsyncIO.h"
+#include "Variable.h"
+#include "nodenetcdfjs.h"
+#include <algorithm>
+#include <node_buffer.h>
+#include <utility>
+
+namespace nodenetcdfjs
+{
+
+v8::Persistent<v8::Function> ChunkIterator::constructor;
+v8::Persistent<v8::Function> ChunkIterator::readable;
+
+ChunkIterator::ChunkIterator(int parent_id_, int var_id_, nc_type type_, size_t element_size_,
+                             std::vector<size_t> start_, std::vector<size_t> count_, std::vector<size_t> tile_,
+                             std::vector<size_t> origin_)
+    : parent_id(parent_id_)
+    , var_id(var_id_)
+    , type(type_)
+    , element_size(element_size_)
+    , start(std::move(start_))
+    , count(std::move(count_))
+    , tile(std::move(tile_))
+    , origin(std::move(origin_))
+    , position(start.size())
+    , session(AsyncIO::session(parent_id_))
+{
+    v8::Isolate *isolate = v8::Isolate::GetCurrent();
+    v8::Local<v8::Object> obj =
+        v8::Local<v8::Function>::New(isolate, constructor)->NewInstance(isolate->GetCurrentContext()).ToLocalChecked();
+    Wrap(obj);
+    for (size_t d = 0; d < start.size(); d++)
+    {
+        exhausted |= count[d] == 0;
+        position[d] = (start[d] - origin[d]) / tile[d];
+    }
+    prefetch(isolate);
+}
+
+void ChunkIterator::Init(v8::Local<v8::Object> exports, v8::Local<v8::Value> module)
+{
+    v8::Isolate *isolate = exports->GetIsolate();
+    v8::Local<v8::Context> context = isolate->GetCurrentContext();
+    v8::Local<v8::FunctionTemplate> tpl = v8::FunctionTemplate::New(isolate);
+    tpl->SetClassName(v8::String::NewFromUtf8(isolate, "ChunkIterator", v8::NewStringType::kNormal).ToLocalChecked());
+    tpl->InstanceTemplate()->SetInternalFieldCount(1);
+    // No NetCDF calls happen here, so these do not wait for the mutex held by a block being read
+    NODE_SET_PROTOTYPE_METHOD(tpl, "next", ChunkIterator::Next);
+    NODE_SET_PROTOTYPE_METHOD(tpl, "return", ChunkIterator::Return);
+    tpl->PrototypeTemplate()->Set(v8::Symbol::GetAsyncIterator(isolate),
+                                  v8::FunctionTemplate::New(isolate, ChunkIterator::Self));
+    constructor.Reset(isolate, tpl->GetFunction(context).ToLocalChecked());
+
+    // Looked up once, the stream built-in cannot change afterwards
+    v8::Local<v8::Function> readable_class;
+    if (stream_class(isolate, module, "Readable").ToLocal(&readable_class))
+        readable.Reset(isolate, readable_class);
+}
+
+void ChunkIterator::Next(const v8::FunctionCallbackInfo<v8::Value> &args)
+{
+    v8::Isolate *isolate = args.GetIsolate();
+    ChunkIterator *obj = node::ObjectWrap::Unwrap<ChunkIterator>(args.Holder());
+    args.GetReturnValue().Set(obj->next(isolate));
+}
+
+void ChunkIterator::Return(const v8::FunctionCallbackInfo<v8::Value> &args)
+{
+    v8::Isolate *isolate = args.GetIsolate();
+    ChunkIterator *obj = node::ObjectWrap::Unwrap<ChunkIterator>(args.Holder());
+    obj->stop(isolate);
+    v8::Local<v8::Promise::Resolver> resolver = v8::Promise::Resolver::New(isolate->GetCurrentContext()).ToLocalChecked();
+    (void)resolver->Resolve(isolate->GetCurrentContext(), make_result(isolate, v8::Undefined(isolate), true));
+    args.GetReturnValue().Set(resolver->GetPromise());
+}
+
+void ChunkIterator::Self(const v8::FunctionCallbackInfo<v8::Value> &args)
+{
+    args.GetReturnValue().Set(args.This());
+}
+
+v8::MaybeLocal<v8::Object> ChunkIterator::make_stream(v8::Isolate *isolate, size_t high_water_mark)
+{
+    v8::Local<v8::Context> context = isolate->GetCurrentContext();
+    if (readable.IsEmpty())
+    {
+        isolate->ThrowException(v8::Exception::Error(
+            v8::String::NewFromUtf8Literal(isolate, "stream.Readable is not available in this environment")));
+        return {};
+    }
+    v8::Local<v8::Object> self = handle(isolate);
+    v8::Local<v8::Object> options = v8::Object::New(isolate);
+    (void)options->CreateDataProperty(context, v8::String::NewFromUtf8Literal(isolate, "highWaterMark"),
+                                      v8::Number::New(isolate, static_cast<double>(high_water_mark)));
+    (void)options->CreateDataProperty(context, v8::String::NewFromUtf8Literal(isolate, "read"),
+                                      v8::Function::New(context, StreamRead, self).ToLocalChecked());
+    (void)options->CreateDataProperty(context, v8::String::NewFromUtf8Literal(isolate, "destroy"),
+                                      v8::Function::New(context, StreamDestroy, self).ToLocalChecked());
+    v8::Local<v8::Value> argv[] = {options};
+    return v8::Local<v8::Function>::New(isolate, readable)->NewInstance(context, 1, argv);
+}
+
+void ChunkIterator::StreamRead(const v8::FunctionCallbackInfo<v8::Value> &args)
+{
+    v8::Isolate *isolate = args.GetIsolate();
+    v8::Local<v8::Context> context = isolate->GetCurrentContext();
+    ChunkIterator *obj = node::ObjectWrap::Unwrap<ChunkIterator>(args.Data().As<v8::Object>());
+    v8::Local<v8::Object> stream = args.This();
+    (void)obj->next(isolate)->Then(context, v8::Function::New(context, StreamPush, stream).ToLocalChecked(),
+                                   v8::Function::New(context, StreamFail, stream).ToLocalChecked());
+}
+
+void ChunkIterator::StreamPush(const v8::FunctionCallbackInfo<v8::Value> &args)
+{
+    v8::Isolate *isolate = args.GetIsolate();
+    v8::Local<v8::Context> context = isolate->GetCurrentContext();
+    v8::Local<v8::Object> stream = args.Data().As<v8::Object>();
+    v8::Local<v8::Object> result = args[0].As<v8::Object>();
+    v8::Local<v8::Value> chunk = v8::Null(isolate);
+    if (!result->Get(context, v8::String::NewFromUtf8Literal(isolate, "done")).ToLocalChecked()->BooleanValue(isolate))
+    {
+        v8::Local<v8::Object> value =
+            result->Get(context, v8::String::NewFromUtf8Literal(isolate, "value")).ToLocalChecked().As<v8::Object>();
+        v8::Local<v8::TypedArray> data =
+            value->Get(context, v8::String::NewFromUtf8Literal(isolate, "data")).ToLocalChecked().As<v8::TypedArray>();
+        chunk = node::Buffer::New(isolate, data->Buffer(), data->ByteOffset(), data->ByteLength()).ToLocalChecked();
+    }
+    v8::Local<v8::Value> push;
+    if (stream->Get(context, v8::String::NewFromUtf8Literal(isolate, "push")).ToLocal(&push) && push->IsFunction())
+        (void)push.As<v8::Function>()->Call(context, stream, 1, &chunk);
+}
+
+void ChunkIterator::StreamFail(const v8::FunctionCallbackInfo<v8::Value> &args)
+{
+    v8::Isolate *isolate = args.GetIsolate();
+    v8::Local<v8::Context> context = isolate->GetCurrentContext();
+    v8::Local<v8::Object> stream = args.Data().As<v8::Object>();
+    v8::Local<v8::Value> error = args[0];
+    v8::Local<v8::Value> destroy;
+    if (stream->Get(context, v8::String::NewFromUtf8Literal(isolate, "destroy")).ToLocal(&destroy) &&
+        destroy->IsFunction())
+        (void)destroy.As<v8::Function>()->Call(context, stream, 1, &error);
+}
+
+void ChunkIterator::StreamDestroy(const v8::FunctionCallbackInfo<v8::Value> &args)
+{
+    v8::Isolate *isolate = args.GetIsolate();
+    ChunkIterator *obj = node::ObjectWrap::Unwrap<ChunkIterator>(args.Data().As<v8::Object>());
+    obj->stop(isolate);
+    if (args.Length() > 1 && args[1]->IsFunction())
+    {
+        v8::Local<v8::Value> error = args[0];
+        (void)args[1].As<v8::Function>()->Call(isolate->GetCurrentContext(), args.This(), 1, &error);
+    }
+}
+
+void ChunkIterator::execute(Block *block)
+{
+    const ChunkIterator *owner = block->owner;
+    block->retval = nc_get_vara(owner->parent_id, owner->var_id, block->start.data(), block->count.data(),
+                                block->store->Data());
+}
+
+void ChunkIterator::complete(Block *block)
+{
+    ChunkIterator *owner = block->owner;
+    block->complete = true;
+    v8::Isolate *isolate = v8::Isolate::GetCurrent();
+    v8::HandleScope scope(isolate);
+    v8::Local<v8::Object> holder = owner->handle(isolate);
+    v8::Local<v8::Context> context = holder->GetCreationContextChecked();
+    v8::Context::Scope context_scope(context);
+    node::CallbackScope callback_scope(isolate, holder, {0, 0});
+    if (owner->stopped)
+        owner->pending.reset();
+    owner->settle(isolate);
+    AsyncIO::end(owner->parent_id);
+    owner->Unref();
+}
+
+v8::Local<v8::Promise> ChunkIterator::next(v8::Isolate *isolate)
+{
+    v8::Local<v8::Promise::Resolver> resolver = v8::Promise::Resolver::New(isolate->GetCurrentContext()).ToLocalChecked();
+    waiting.emplace_back(isolate, resolver);
+    settle(isolate);
+    return resolver->GetPromise();
+}
+
+void ChunkIterator::stop(v8::Isolate *isolate)
+{
+    stopped = true;
+    // A block still being read is dropped by complete()
+    if (pending && pending->complete)
+        pending.reset();
+    settle(isolate);
+}
+
+void ChunkIterator::prefetch(v8::Isolate *isolate)
+{
+    if (exhausted || stopped)
+        return;
+
+    auto block = std::make_unique<Block>();
+    block->owner = this;
+    block->start.resize(start.size());
+    block->count.resize(start.size());
+    block->length = 1;
+    for (size_t d = 0; d < start.size(); d++)
+    {
+        block->start[d] = std::max(start[d], origin[d] + position[d] * tile[d]);
+        block->count[d] = std::min(start[d] + count[d], origin[d] + (position[d] + 1) * tile[d]) - block->start[d];
+        block->length *= block->count[d];
+    }
+    block->store = v8::ArrayBuffer::NewBackingStore(isolate, block->length * element_size);
+
+    // Step to the next grid position in C order, fastest dimension last
+    size_t d = start.size();
+    for (; d > 0; d--)
+    {
+        if (++position[d - 1] <= (start[d - 1] + count[d - 1] - 1 - origin[d - 1]) / tile[d - 1])
+            break;
+        position[d - 1] = (start[d - 1] - origin[d - 1]) / tile[d - 1];
+    }
+    exhausted = d == 0;
+
+    if (!AsyncIO::begin(parent_id, session))
+    {
+        // The file was closed since the iteration started
+        block->retval = NC_EBADID;
+        block->complete = true;
+    }
+    else
+    {
+        // Keep the wrapper alive while the I/O thread owns the block
+        Ref();
+        Block *queued = block.get();
+        AsyncIO::queue(isolate, [queued] { execute(queued); }, [queued] { complete(queued); });
+    }
+    pending = std::move(block);
+}
+
+void ChunkIterator::settle(v8::Isolate *isolate)
+{
+    v8::Local<v8::Context> context = isolate->GetCurrentContext();
+    while (!waiting.empty())
+    {
+        if (pending && !pending->complete)
+            return;
+        v8::Local<v8::Promise::Resolver> resolver = waiting.front().Get(isolate);
+        waiting.pop_front();
+        if (!pending || stopped)
+        {
+            (void)resolver->Resolve(context, make_result(isolate, v8::Undefined(isolate), true));
+            continue;
+        }
+
+        const std::unique_ptr<Block> block = std::move(pending);
+        if (block->retval != NC_NOERR)
+        {
+            stopped = true;
+            (void)resolver->Reject(context, netcdf_error(isolate, block->retval));
+            continue;
+        }
+        prefetch(isolate);
+
+        v8::Local<v8::Array> block_start = v8::Array::New(isolate, static_cast<int>(start.size()));
+        v8::Local<v8::Array> block_count = v8::Array::New(isolate, static_cast<int>(start.size()));
+        for (size_t d = 0; d < start.size(); d++)
+        {
+            (void)block_start->Set(context, static_cast<uint32_t>(d),
+                                   v8::Number::New(isolate, static_cast<double>(block->start[d])));
+            (void)block_count->Set(context, static_cast<uint32_t>(d),
+                                   v8::Number::New(isolate, static_cast<double>(block->count[d])));
+        }
+        v8::Local<v8::Object> value = v8::Object::New(isolate);
+        (void)value->CreateDataProperty(context, v8::String::NewFromUtf8Literal(isolate, "start"), block_start);
+        (void)value->CreateDataProperty(context, v8::String::NewFromUtf8Literal(isolate, "count"), block_count);
+        (void)value->CreateDataProperty(
+            context, v8::String::NewFromUtf8Literal(isolate, "data"),
+            Variable::make_typed_array(type, v8::ArrayBuffer::New(isolate, block->store), 0, block->length));
+        (void)resolver->Resolve(context, make_result(isolate, value, false));
+    }
+}
+
+v8::Local<v8::Object> ChunkIterator::make_result(v8::Isolate *isolate, v8::Local<v8::Value> value, bool done)
+{
+    v8::Local<v8::Context> context = isolate->GetCurrentContext();
+    v8::Local<v8::Object> result = v8::Object::New(isolate);
+    (void)result->CreateDataProperty(context, v8::String::NewFromUtf8Literal(isolate, "value"), value);
+    (void)result->CreateDataProperty(context, v8::String::NewFromUtf8Literal(isolate, "done"),
+                                     v8::Boolean::New(isolate, done));
+    return result;
+}
+
+} // namespace nodenetcdfjs
@@ -0,0 +1,226 @@
+#ifndef NODENETCDFJS_CHUNKITERATOR_H
+#define NODENETCDFJS_CHUNKITERATOR_H
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <netcdf.h>
+#include <node.h>
+#include <node_object_wrap.h>
+#include <vector>
+
+namespace nodenetcdfjs
+{
+
+/**
+ * @brief Async iterator over the storage blocks of a variable hyperslab
+ *
+ * Returned by Variable.chunks(). The hyperslab is cut into blocks whose edges lie on
+ * the storage chunk grid, so each chunk is decompressed once. Every block is read on
+ * the I/O thread of AsyncIO, and the next block is queued as soon as one is handed to
+ * JavaScript, so file reads overlap with processing while at most two blocks are alive.
+ *
+ * The object implements the async iterator protocol (next, return and
+ * Symbol.asyncIterator) and can be used directly in for await...of loops. It also
+ * backs Variable.createReadStream(), where blocks are pulled by a stream.Readable.
+ */
+class ChunkIterator : public node::ObjectWrap
+{
+  public:
+    /**
+     * @brief Initialize the ChunkIterator class
+     * @param exports The module exports (the constructor is not exported)
+     * @param module The addon module, used to require the stream built-in
+     */
+    static void Init(v8::Local<v8::Object> exports, v8::Local<v8::Value> module);
+
+    /**
+     * @brief Construct an iterator and queue the read of its first block
+     * @param parent_id_ The parent group/file ID
+     * @param var_id_ The variable ID
+     * @param type_ The NetCDF type of the variable
+     * @param element_size_ Size in bytes of one element
+     * @param start_ Start of the hyperslab for each dimension
+     * @param count_ Extent of the hyperslab for each dimension
+     * @param tile_ Block shape
+     * @param origin_ Corner of the block grid, at most start_ in each dimension
+     */
+    ChunkIterator(int parent_id_, int var_id_, nc_type type_, size_t element_size_, std::vector<size_t> start_,
+                  std::vector<size_t> count_, std::vector<size_t> tile_, std::vector<size_t> origin_);
+
+    /**
+     * @brief Create a stream.Readable of Buffers pulling blocks from this iterator
+     * @param isolate The V8 isolate
+     * @param high_water_mark highWaterMark of the stream in bytes
+     * @return The stream, or an empty handle if a JavaScript exception is pending
+     *
+     * A block is only requested when the stream calls read(), so a consumer applying
+     * backpressure stops the reads after the one block already queued.
+     */
+    [[nodiscard]] v8::MaybeLocal<v8::Object> make_stream(v8::Isolate *isolate, size_t high_water_mark);
+
+  private:
+    // Delete copy and move operations for safety
+    ChunkIterator(const ChunkIterator &) = delete;
+    ChunkIterator &operator=(const ChunkIterator &) = delete;
+    ChunkIterator(ChunkIterator &&) = delete;
+    ChunkIterator &operator=(ChunkIterator &&) = delete;
+
+    /**
+     * @brief One block read, owned by the iterator while queued or waiting to be consumed
+     *
+     * Only plain data is touched on the I/O thread.
+     */
+    struct Block
+    {
+        ChunkIterator *owner{nullptr};
+        std::vector<size_t> start;
+        std::vector<size_t> count;
+        std::shared_ptr<v8::BackingStore> store;
+        size_t length{0};
+        int retval{NC_NOERR};
+        bool complete{false};
+    };
+
+    /// Persistent reference to the JavaScript constructor function
+    static v8::Persistent<v8::Function> constructor;
+
+    /// Persistent reference to stream.Readable
+    static v8::Persistent<v8::Function> readable;
+
+    /**
+     * @brief Resolve with the next block as { value: { start, count, data }, done }
+     * @param args JavaScript function arguments (none)
+     */
+    static void Next(const v8::FunctionCallbackInfo<v8::Value> &args);
+
+    /**
+     * @brief Stop the iteration early, as done by break in a for await...of loop
+     * @param args JavaScript function arguments (ignored)
+     */
+    static void Return(const v8::FunctionCallbackInfo<v8::Value> &args);
+
+    /**
+     * @brief Symbol.asyncIterator, returning the iterator itself
+     * @param args JavaScript function arguments (none)
+     */
+    static void Self(const v8::FunctionCallbackInfo<v8::Value> &args);
+
+    /**
+     * @brief read() of a stream made by make_stream(), requesting the next block
+     * @param args JavaScript function arguments; data is the iterator, this is the stream
+     */
+    static void StreamRead(const v8::FunctionCallbackInfo<v8::Value> &args);
+
+    /**
+     * @brief Push a block, or the end of the data, into a stream
+     * @param args JavaScript function arguments (iterator result); data is the stream
+     */
+    static void StreamPush(const v8::FunctionCallbackInfo<v8::Value> &args);
+
+    /**
+     * @brief Destroy a stream after a failed read
+     * @param args JavaScript function arguments (error); data is the stream
+     */
+    static void StreamFail(const v8::FunctionCallbackInfo<v8::Value> &args);
+
+    /**
+     * @brief destroy() of a stream made by make_stream(), stopping the iterator
+     * @param args JavaScript function arguments (error, callback); data is the iterator
+     */
+    static void StreamDestroy(const v8::FunctionCallbackInfo<v8::Value> &args);
+
+    /**
+     * @brief Queue a promise for the next block
+     * @param isolate The V8 isolate
+     * @return Promise resolving to an iterator result
+     */
+    [[nodiscard]] v8::Local<v8::Promise> next(v8::Isolate *isolate);
+
+    /**
+     * @brief Stop the iteration, settling waiting promises with done
+     * @param isolate The V8 isolate
+     */
+    void stop(v8::Isolate *isolate);
+
+    /**
+     * @brief Read a block on the I/O thread
+     * @param block The block to read
+     */
+    static void execute(Block *block);
+
+    /**
+     * @brief Mark a block complete on the JavaScript thread and settle waiting promises
+     * @param block The block that has been read
+     */
+    static void complete(Block *block);
+
+    /**
+     * @brief Queue the read of the block at the current tile position, if any remains
+     * @param isolate The V8 isolate
+     */
+    void prefetch(v8::Isolate *isolate);
+
+    /**
+     * @brief Hand completed blocks to waiting next() promises
+     * @param isolate The V8 isolate
+     *
+     * Called whenever a block completes or a promise starts waiting.
+     */
+    void settle(v8::Isolate *isolate);
+
+    /**
+     * @brief Build an iterator result object
+     * @param isolate The V8 isolate
+     * @param value The value, or undefined at the end
+     * @param done Whether the iteration is finished
+     */
+    [[nodiscard]] static v8::Local<v8::Object> make_result(v8::Isolate *isolate, v8::Local<v8::Value> value,
+                                                          bool done);
+
+    /// The parent group/file ID
+    int parent_id{-1};
+
+    /// The variable ID
+    int var_id{-1};
+
+    /// The NetCDF data type of the variable
+    nc_type type{NC_NAT};
+
+    /// Size in bytes of one element
+    size_t element_size{0};
+
+    /// Start of the hyperslab
+    std::vector<size_t> start;
+
+    /// Extent of the hyperslab
+    std::vector<size_t> count;
+
+    /// Block shape
+    std::vector<size_t> tile;
+
+    /// Corner of the block grid
+    std::vector<size_t> origin;
+
+    /// Grid position of the next block to queue
+    std::vector<size_t> position;
+
+    /// Session of the file, so that no block is read after it is closed (see AsyncIO)
+    uint64_t session{0};
+
+    /// Whether every block has been queued
+    bool exhausted{false};
+
+    /// Whether return() was called or a read failed
+    bool stopped{false};
+
+    /// The block being read or waiting to be consumed
+    std::unique_ptr<Block> pending;
+
+    /// Promises returned by next() that are not settled yet
+    std::deque<v8::Global<v8::Promise::Resolver>> waiting;
+};
+
+} // namespace nodenetcdfjs
+
+#endif
@@ -1,4 +1,5 @@
 #include "Dimension.h"
+#include "WrapperCache.h"
 #include "nodenetcdfjs.h"
 #include <netcdf.h>
 
@@ -23,15 +24,17 @@ void Dimension::Init(v8::Local<v8::Object> exports)
     v8::Local<v8::FunctionTemplate> tpl = v8::FunctionTemplate::New(isolate);
     tpl->SetClassName(v8::String::NewFromUtf8(isolate, "Dimension", v8::NewStringType::kNormal).ToLocalChecked());
     tpl->InstanceTemplate()->SetInternalFieldCount(1);
-    NODE_SET_PROTOTYPE_METHOD(tpl, "inspect", Dimension::Inspect);
-    NODE_SET_PROTOTYPE_METHOD(tpl, "toJSON", Dimension::ToJSON);
+    NODE_SET_PROTOTYPE_METHOD(tpl, "inspect", serialized<Dimension::Inspect>);
+    NODE_SET_PROTOTYPE_METHOD(tpl, "toJSON", serialized<Dimension::ToJSON>);
     tpl->InstanceTemplate()->SetAccessor(
-        v8::String::NewFromUtf8(isolate, "id", v8::NewStringType::kNormal).ToLocalChecked(), Dimension::GetId);
+        v8::String::NewFromUtf8(isolate, "id", v8::NewStringType::kNormal).ToLocalChecked(),
+        serialized<Dimension::GetId>);
     tpl->InstanceTemplate()->SetAccessor(
-        v8::String::NewFromUtf8(isolate, "length", v8::NewStringType::kNormal).ToLocalChecked(), Dimension::GetLength);
+        v8::String::NewFromUtf8(isolate, "length", v8::NewStringType::kNormal).ToLocalChecked(),
+        serialized<Dimension::GetLength>);
     tpl->InstanceTemplate()->SetAccessor(
-        v8::String::NewFromUtf8(isolate, "name", v8::NewStringType::kNormal).ToLocalChecked(), Dimension::GetName,
-        Dimension::SetName);
+        v8::String::NewFromUtf8(isolate, "name", v8::NewStringType::kNormal).ToLocalChecked(),
+        serialized<Dimension::GetName>, serialized<Dimension::SetName>);
     constructor.Reset(isolate, tpl->GetFunction(isolate->GetCurrentContext()).ToLocalChecked());
 }
 
@@ -91,7 +94,13 @@ void Dimension::SetName(v8::Local<v8::String> property, v8::Local<v8::Value> val
     const int retval = nc_rename_dim(obj->parent_id, obj->id, *new_name_);
 
     if (retval != NC_NOERR)
+    {
         throw_netcdf_error(isolate, retval);
+        return;
+    }
+    // The dimension may be listed by an ancestor of parent_id, so drop the keyed collections file-wide
+    WrapperCache::erase_all(WrapperCache::Kind::Dimensions, obj->parent_id);
+    WrapperCache::erase_all(WrapperCache::Kind::Unlimited, obj->parent_id);
 }
 
 void Dimension::Inspect(const v8::FunctionCallbackInfo<v8::Value> &args)
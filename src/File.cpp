@@ -1,13 +1,112 @@
 #include "File.h"
+#include "AsyncIO.h"
 #include "Group.h"
+#include "MappedFile.h"
+#include "Metadata.h"
 #include "Variable.h"
+#include "WrapperCache.h"
 #include "nodenetcdfjs.h"
+#include <algorithm>
+#include <cstdlib>
+#include <limits>
 #include <netcdf.h>
+#include <node_buffer.h>
 #include <string>
+#include <vector>
 
 namespace nodenetcdfjs
 {
 
+namespace
+{
+/// Default upper bound of the caches pinned by decompressOnOpen
+constexpr size_t default_pin_bytes = size_t{1} << 30;
+
+/**
+ * @brief Decompress every chunk of a group's variables into caches sized to keep them all
+ * @param ncid The group, walked together with its subgroups
+ * @param budget Bytes still available for pinned caches, decreased by each pinned variable
+ * @return NC_NOERR on success, the NetCDF error code otherwise
+ *
+ * Each chunked variable gets a cache with room for all of its chunks, at least one hash
+ * slot per chunk and preemption 0, then every chunk is read once. Nothing is evicted
+ * afterwards, so reads are served from decompressed chunks. Variables whose chunks do not
+ * fit in the remaining budget keep their default cache.
+ */
+int pin_chunks(int ncid, size_t &budget) noexcept
+{
+    int nvars = 0;
+    int retval = nc_inq_varids(ncid, &nvars, nullptr);
+    std::vector<int> varids(nvars);
+    if (retval == NC_NOERR && nvars > 0)
+        retval = nc_inq_varids(ncid, nullptr, varids.data());
+    for (int v = 0; v < nvars && retval == NC_NOERR; v++)
+    {
+        int ndims = 0;
+        nc_type type = NC_NAT;
+        size_t type_size = 0;
+        int storage = NC_CONTIGUOUS;
+        retval = nc_inq_varndims(ncid, varids[v], &ndims);
+        if (retval != NC_NOERR || ndims == 0)
+            continue;
+        std::vector<size_t> chunk(ndims);
+        std::vector<int> dimids(ndims);
+        std::vector<size_t> shape(ndims);
+        retval = nc_inq_var_chunking(ncid, varids[v], &storage, chunk.data());
+        if (retval == NC_NOERR)
+            retval = nc_inq_vartype(ncid, varids[v], &type);
+        // Strings and user-defined types hold pointers, not plain chunk data
+        if (retval != NC_NOERR || storage != NC_CHUNKED || type >= NC_STRING)
+            continue;
+        retval = nc_inq_type(ncid, type, nullptr, &type_size);
+        if (retval == NC_NOERR)
+            retval = nc_inq_vardimid(ncid, varids[v], dimids.data());
+        size_t nchunks = 1;
+        size_t chunk_bytes = type_size;
+        for (int d = 0; d < ndims && retval == NC_NOERR; d++)
+        {
+            retval = nc_inq_dimlen(ncid, dimids[d], &shape[d]);
+            nchunks *= (shape[d] + chunk[d] - 1) / chunk[d];
+            chunk_bytes *= chunk[d];
+        }
+        if (retval != NC_NOERR || nchunks == 0 || chunk_bytes == 0 || nchunks > budget / chunk_bytes)
+            continue;
+        budget -= nchunks * chunk_bytes;
+        retval = nc_set_var_chunk_cache(ncid, varids[v], nchunks * chunk_bytes, next_prime(nchunks), 0.0f);
+
+        std::vector<uint8_t> scratch(chunk_bytes);
+        std::vector<size_t> position(ndims, 0);
+        std::vector<size_t> start(ndims);
+        std::vector<size_t> count(ndims);
+        for (size_t c = 0; c < nchunks && retval == NC_NOERR; c++)
+        {
+            for (int d = 0; d < ndims; d++)
+            {
+                start[d] = position[d] * chunk[d];
+                count[d] = std::min(chunk[d], shape[d] - start[d]);
+            }
+            retval = nc_get_vara(ncid, varids[v], start.data(), count.data(), scratch.data());
+            for (int d = ndims - 1; d >= 0; d--)
+            {
+                if (++position[d] * chunk[d] < shape[d])
+                    break;
+                position[d] = 0;
+            }
+        }
+    }
+
+    int ngroups = 0;
+    if (retval == NC_NOERR)
+        retval = nc_inq_grps(ncid, &ngroups, nullptr);
+    std::vector<int> groups(ngroups);
+    if (retval == NC_NOERR && ngroups > 0)
+        retval = nc_inq_grps(ncid, nullptr, groups.data());
+    for (int g = 0; g < ngroups && retval == NC_NOERR; g++)
+        retval = pin_chunks(groups[g], budget);
+    return retval;
+}
+} // namespace
+
 v8::Persistent<v8::Function> File::constructor;
 
 File::File(int id_) noexcept
@@ -18,23 +117,44 @@ File::File(int id_) noexcept
 
 File::~File()
 {
-    if (!closed)
+    const std::lock_guard<std::recursive_mutex> lock(netcdf_mutex());
+    if (!closed && AsyncIO::pending(id) > 0)
     {
-        if (const int retval = nc_close(id); retval != NC_NOERR)
-            throw_netcdf_error(v8::Isolate::GetCurrent(), retval);
+        // Operations still use the file; the last one to finish closes it, keeping a file image alive until then
+        AsyncIO::close(id, [id = id, memory = memory] {
+            const std::lock_guard<std::recursive_mutex> lock(netcdf_mutex());
+            (void)Variable::flush_appends(id, true);
+            WrapperCache::purge(id);
+            MappedFile::detach(id);
+            (void)nc_close(id);
+            forget_file(id);
+        });
+    }
+    else if (!closed)
+    {
+        AsyncIO::close(id, [] {});
+        const int flushed = Variable::flush_appends(id, true);
+        WrapperCache::purge(id);
+        MappedFile::detach(id);
+        const int retval = nc_close(id);
+        forget_file(id);
+        if (retval != NC_NOERR || flushed != NC_NOERR)
+            throw_netcdf_error(v8::Isolate::GetCurrent(), retval != NC_NOERR ? retval : flushed);
     }
 }
 
 void File::Init(v8::Local<v8::Object> exports)
 {
     v8::Isolate *isolate = exports->GetIsolate();
-    v8::Local<v8::FunctionTemplate> tpl = v8::FunctionTemplate::New(isolate, New);
+    v8::Local<v8::FunctionTemplate> tpl = v8::FunctionTemplate::New(isolate, serialized<New>);
     tpl->SetClassName(v8::String::NewFromUtf8(isolate, "File", v8::NewStringType::kNormal).ToLocalChecked());
     tpl->InstanceTemplate()->SetInternalFieldCount(1);
-    NODE_SET_PROTOTYPE_METHOD(tpl, "sync", File::Sync);
-    NODE_SET_PROTOTYPE_METHOD(tpl, "close", File::Close);
-    NODE_SET_PROTOTYPE_METHOD(tpl, "inspect", File::Inspect);
-    NODE_SET_PROTOTYPE_METHOD(tpl, "toJSON", File::ToJSON);
+    NODE_SET_PROTOTYPE_METHOD(tpl, "sync", serialized<File::Sync>);
+    NODE_SET_PROTOTYPE_METHOD(tpl, "close", serialized<File::Close>);
+    NODE_SET_PROTOTYPE_METHOD(tpl, "inspect", serialized<File::Inspect>);
+    NODE_SET_PROTOTYPE_METHOD(tpl, "toJSON", serialized<File::ToJSON>);
+    NODE_SET_PROTOTYPE_METHOD(tpl, "describe", serialized<File::Describe>);
+    NODE_SET_PROTOTYPE_METHOD(tpl, "get", serialized<File::Get>);
     constructor.Reset(isolate, tpl->GetFunction(isolate->GetCurrentContext()).ToLocalChecked());
     exports->Set(isolate->GetCurrentContext(),
                  v8::String::NewFromUtf8(isolate, "File", v8::NewStringType::kNormal).ToLocalChecked(),
@@ -55,15 +175,23 @@ void File::New(const v8::FunctionCallbackInfo<v8::Value> &args)
 
     if (args.IsConstructCall())
     {
+        // A Buffer, typed array or ArrayBuffer holds the file image itself
+        const bool from_memory = args[0]->IsArrayBufferView() || args[0]->IsArrayBuffer();
         const std::string filename =
-            *v8::String::Utf8Value(isolate, args[0]->ToString(isolate->GetCurrentContext()).ToLocalChecked());
+            from_memory ? std::string("<memory>")
+                        : *v8::String::Utf8Value(isolate, args[0]->ToString(isolate->GetCurrentContext()).ToLocalChecked());
         const std::string mode_arg =
             *v8::String::Utf8Value(isolate, args[1]->ToString(isolate->GetCurrentContext()).ToLocalChecked());
 
         int format = NC_NETCDF4;
         int id = -1;
 
-        if (args.Length() > 2)
+        // An options object may follow the mode or the format
+        v8::Local<v8::Object> options;
+        if (args.Length() > 2 && args[args.Length() - 1]->IsObject())
+            options = args[args.Length() - 1].As<v8::Object>();
+
+        if (args.Length() > 2 && !args[2]->IsObject())
         {
             const std::string format_arg =
                 *v8::String::Utf8Value(isolate, args[2]->ToString(isolate->GetCurrentContext()).ToLocalChecked());
@@ -72,6 +200,8 @@ void File::New(const v8::FunctionCallbackInfo<v8::Value> &args)
                 format = 0;
             else if (format_arg == "classic64")
                 format = NC_64BIT_OFFSET;
+            else if (format_arg == "cdf5")
+                format = NC_64BIT_DATA;
             else if (format_arg == "nodenetcdf")
                 format = NC_NETCDF4;
             else if (format_arg == "nodenetcdfclassic")
@@ -85,31 +215,192 @@ void File::New(const v8::FunctionCallbackInfo<v8::Value> &args)
             }
         }
 
+        if (mode_arg != "r" && mode_arg != "w" && mode_arg != "c" && mode_arg != "c!")
+        {
+            isolate->ThrowException(v8::Exception::TypeError(
+                v8::String::NewFromUtf8(isolate, "Unknown file mode", v8::NewStringType::kNormal).ToLocalChecked()));
+            return;
+        }
+        std::shared_ptr<v8::BackingStore> memory;
+        size_t memory_offset = 0;
+        size_t memory_size = 0;
+        if (from_memory)
+        {
+            if (mode_arg != "r")
+            {
+                isolate->ThrowException(v8::Exception::TypeError(
+                    v8::String::NewFromUtf8Literal(isolate, "A file in a Buffer can only be opened in mode 'r'")));
+                return;
+            }
+            if (args[0]->IsArrayBufferView())
+            {
+                v8::Local<v8::ArrayBufferView> view = args[0].As<v8::ArrayBufferView>();
+                memory = view->Buffer()->GetBackingStore();
+                memory_offset = view->ByteOffset();
+                memory_size = view->ByteLength();
+            }
+            else
+            {
+                memory = args[0].As<v8::ArrayBuffer>()->GetBackingStore();
+                memory_size = memory->ByteLength();
+            }
+        }
+
+        bool in_memory = false;
+        bool diskless = false;
+        bool decompress_on_open = false;
+        size_t pin_bytes = default_pin_bytes;
+        bool map = false;
+        size_t initial_size = 0;
+        if (!options.IsEmpty())
+        {
+            v8::Local<v8::Context> context = isolate->GetCurrentContext();
+            in_memory = options->Get(context, v8::String::NewFromUtf8Literal(isolate, "inMemory"))
+                            .ToLocalChecked()
+                            ->BooleanValue(isolate);
+            initial_size = static_cast<size_t>(
+                options->Get(context, v8::String::NewFromUtf8Literal(isolate, "initialSize"))
+                    .ToLocalChecked()
+                    ->IntegerValue(context)
+                    .FromMaybe(0));
+            diskless = options->Get(context, v8::String::NewFromUtf8Literal(isolate, "diskless"))
+                           .ToLocalChecked()
+                           ->BooleanValue(isolate);
+            v8::Local<v8::Value> decompress =
+                options->Get(context, v8::String::NewFromUtf8Literal(isolate, "decompressOnOpen")).ToLocalChecked();
+            decompress_on_open = decompress->BooleanValue(isolate);
+            if (decompress->IsObject())
+            {
+                v8::Local<v8::Value> max_value = decompress.As<v8::Object>()
+                                                     ->Get(context, v8::String::NewFromUtf8Literal(isolate, "maxBytes"))
+                                                     .ToLocalChecked();
+                if (!max_value->IsUndefined())
+                {
+                    const double requested = max_value->NumberValue(context).FromMaybe(-1);
+                    if (!(requested >= 0))
+                    {
+                        isolate->ThrowException(v8::Exception::RangeError(v8::String::NewFromUtf8Literal(
+                            isolate, "decompressOnOpen.maxBytes must be a non-negative number")));
+                        return;
+                    }
+                    pin_bytes =
+                        requested < 9.0e15 ? static_cast<size_t>(requested) : std::numeric_limits<size_t>::max();
+                }
+            }
+            map = options->Get(context, v8::String::NewFromUtf8Literal(isolate, "mmap"))
+                      .ToLocalChecked()
+                      ->BooleanValue(isolate);
+            if (in_memory && mode_arg != "c" && mode_arg != "c!")
+            {
+                isolate->ThrowException(v8::Exception::TypeError(
+                    v8::String::NewFromUtf8Literal(isolate, "inMemory needs a create mode ('c' or 'c!')")));
+                return;
+            }
+            if (diskless && (mode_arg != "r" || from_memory))
+            {
+                isolate->ThrowException(v8::Exception::TypeError(
+                    v8::String::NewFromUtf8Literal(isolate, "diskless needs mode 'r' and a path")));
+                return;
+            }
+            if (decompress_on_open && mode_arg != "r")
+            {
+                isolate->ThrowException(v8::Exception::TypeError(
+                    v8::String::NewFromUtf8Literal(isolate, "decompressOnOpen needs mode 'r'")));
+                return;
+            }
+            if (map && (mode_arg != "r" || from_memory))
+            {
+                isolate->ThrowException(v8::Exception::TypeError(
+                    v8::String::NewFromUtf8Literal(isolate, "mmap needs mode 'r' and a path")));
+                return;
+            }
+        }
+
+        // The library only applies a chunk cache size when a file is opened, so swap the default around the open
+        size_t default_cache_size = 0;
+        size_t default_cache_nelems = 0;
+        float default_cache_preemption = 0;
+        bool cache_override = false;
+        if (!options.IsEmpty())
+        {
+            v8::Local<v8::Value> cache =
+                options->Get(isolate->GetCurrentContext(), v8::String::NewFromUtf8Literal(isolate, "chunkCache"))
+                    .ToLocalChecked();
+            if (!cache->IsUndefined())
+            {
+                if (!cache->IsObject())
+                {
+                    isolate->ThrowException(v8::Exception::TypeError(v8::String::NewFromUtf8Literal(
+                        isolate, "chunkCache must be an object { size, nelems, preemption }")));
+                    return;
+                }
+                int retval = nc_get_chunk_cache(&default_cache_size, &default_cache_nelems, &default_cache_preemption);
+                size_t cache_size = default_cache_size;
+                size_t cache_nelems = default_cache_nelems;
+                float cache_preemption = default_cache_preemption;
+                if (retval == NC_NOERR &&
+                    !get_chunk_cache_options(isolate, cache.As<v8::Object>(), cache_size, cache_nelems,
+                                             cache_preemption))
+                    return;
+                if (retval == NC_NOERR)
+                    retval = nc_set_chunk_cache(cache_size, cache_nelems, cache_preemption);
+                if (retval != NC_NOERR)
+                {
+                    throw_netcdf_error(isolate, retval);
+                    return;
+                }
+                cache_override = true;
+            }
+        }
+
         int retval = NC_NOERR;
-        if (mode_arg == "r")
-            retval = nc_open(filename.c_str(), NC_NOWRITE, &id);
+        if (from_memory)
+            retval = nc_open_mem(filename.c_str(), NC_NOWRITE, memory_size,
+                                 static_cast<uint8_t *>(memory->Data()) + memory_offset, &id);
+        else if (in_memory)
+            retval = nc_create_mem(filename.c_str(), format, initial_size, &id);
+        else if (mode_arg == "r")
+            retval = nc_open(filename.c_str(), NC_NOWRITE | (diskless ? NC_DISKLESS : 0), &id);
         else if (mode_arg == "w")
             retval = nc_open(filename.c_str(), NC_WRITE, &id);
         else if (mode_arg == "c")
             retval = nc_create(filename.c_str(), format | NC_NOCLOBBER, &id);
-        else if (mode_arg == "c!")
-            retval = nc_create(filename.c_str(), format | NC_CLOBBER, &id);
         else
+            retval = nc_create(filename.c_str(), format | NC_CLOBBER, &id);
+        if (cache_override)
+            (void)nc_set_chunk_cache(default_cache_size, default_cache_nelems, default_cache_preemption);
+        if (retval == NC_NOERR && decompress_on_open)
         {
-            isolate->ThrowException(v8::Exception::TypeError(
-                v8::String::NewFromUtf8(isolate, "Unknown file mode", v8::NewStringType::kNormal).ToLocalChecked()));
-            return;
+            retval = pin_chunks(id, pin_bytes);
+            if (retval != NC_NOERR)
+            {
+                (void)nc_close(id);
+                forget_file(id);
+            }
         }
         if (retval != NC_NOERR)
         {
             throw_netcdf_error(isolate, retval);
             return;
         }
+        // Only the classic formats store variables contiguously at offsets given in the header
+        int opened_format = 0;
+        if (map && nc_inq_format(id, &opened_format) == NC_NOERR &&
+            (opened_format == NC_FORMAT_CLASSIC || opened_format == NC_FORMAT_64BIT_OFFSET ||
+             opened_format == NC_FORMAT_CDF5))
+        {
+            if (std::shared_ptr<MappedFile> mapped = MappedFile::open(filename))
+                MappedFile::attach(id, std::move(mapped));
+        }
+        AsyncIO::open(id);
         auto *obj = new File(id);
+        obj->memory = std::move(memory);
+        obj->in_memory = in_memory;
         obj->Wrap(args.This());
         args.This()->Set(isolate->GetCurrentContext(),
                          v8::String::NewFromUtf8(isolate, "root", v8::NewStringType::kNormal).ToLocalChecked(),
-                         (new Group(id))->handle());
+                         WrapperCache::lookup(isolate, WrapperCache::Kind::Group, id, 0, {},
+                                              [id] { return (new Group(id))->handle(); }));
         args.GetReturnValue().Set(args.This());
     }
     else
@@ -124,18 +415,50 @@ void File::New(const v8::FunctionCallbackInfo<v8::Value> &args)
 void File::Sync(const v8::FunctionCallbackInfo<v8::Value> &args)
 {
     File *obj = node::ObjectWrap::Unwrap<File>(args.Holder());
-    int retval = nc_sync(obj->id);
+    int retval = Variable::flush_appends(obj->id, false);
+    if (retval == NC_NOERR)
+        retval = nc_sync(obj->id);
     if (retval != NC_NOERR)
         throw_netcdf_error(args.GetIsolate(), retval);
 }
 
 void File::Close(const v8::FunctionCallbackInfo<v8::Value> &args)
 {
+    v8::Isolate *isolate = args.GetIsolate();
     File *obj = node::ObjectWrap::Unwrap<File>(args.Holder());
-    int retval = nc_close(obj->id);
+    if (const size_t pending = AsyncIO::pending(obj->id); pending > 0)
+    {
+        char error_msg[256];
+        snprintf(error_msg, sizeof(error_msg),
+                 "File.close(): %zu asynchronous operation(s) still running on the file; await them before closing",
+                 pending);
+        isolate->ThrowException(v8::Exception::Error(
+            v8::String::NewFromUtf8(isolate, error_msg, v8::NewStringType::kNormal).ToLocalChecked()));
+        return;
+    }
+    const int flushed = Variable::flush_appends(obj->id, true);
+    WrapperCache::purge(obj->id);
+    MappedFile::detach(obj->id);
+    NC_memio image{};
+    int retval = obj->in_memory ? nc_close_memio(obj->id, &image) : nc_close(obj->id);
+    forget_file(obj->id);
+    if (retval == NC_NOERR)
+    {
+        AsyncIO::close(obj->id, [] {});
+        obj->closed = true;
+        obj->memory.reset();
+        retval = flushed;
+    }
+    if (image.memory != nullptr)
+    {
+        // The Buffer takes ownership of the image malloc()ed by the library
+        args.GetReturnValue().Set(node::Buffer::New(
+                                      args.GetIsolate(), static_cast<char *>(image.memory), image.size,
+                                      [](char *data, void *) { std::free(data); }, nullptr)
+                                      .ToLocalChecked());
+    }
     if (retval != NC_NOERR)
         throw_netcdf_error(args.GetIsolate(), retval);
-    obj->closed = true;
 }
 
 void File::Inspect(const v8::FunctionCallbackInfo<v8::Value> &args)
@@ -172,4 +495,60 @@ void File::ToJSON(const v8::FunctionCallbackInfo<v8::Value> &args)
 
     args.GetReturnValue().Set(root);
 }
+
+void File::Describe(const v8::FunctionCallbackInfo<v8::Value> &args)
+{
+    v8::Isolate *isolate = args.GetIsolate();
+    v8::Local<v8::Context> context = isolate->GetCurrentContext();
+    File *obj = node::ObjectWrap::Unwrap<File>(args.Holder());
+    bool json = false;
+    if (args.Length() > 0 && args[0]->IsObject())
+        json = args[0]
+                   .As<v8::Object>()
+                   ->Get(context, v8::String::NewFromUtf8Literal(isolate, "json"))
+                   .ToLocalChecked()
+                   ->BooleanValue(isolate);
+
+    int retval = NC_NOERR;
+    if (json)
+    {
+        std::string text;
+        retval = Metadata::to_json(obj->id, text);
+        if (retval == NC_NOERR)
+            args.GetReturnValue().Set(
+                v8::String::NewFromUtf8(isolate, text.data(), v8::NewStringType::kNormal, static_cast<int>(text.size()))
+                    .ToLocalChecked());
+    }
+    else
+    {
+        v8::Local<v8::Value> result;
+        if (Metadata::to_object(isolate, obj->id, retval).ToLocal(&result))
+            args.GetReturnValue().Set(result);
+    }
+    if (retval != NC_NOERR)
+        throw_netcdf_error(isolate, retval);
+}
+
+void File::Get(const v8::FunctionCallbackInfo<v8::Value> &args)
+{
+    v8::Isolate *isolate = args.GetIsolate();
+    const File *obj = node::ObjectWrap::Unwrap<File>(args.Holder());
+    if (args.Length() < 1 || !args[0]->IsString())
+    {
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8(isolate, "Expecting a path", v8::NewStringType::kNormal).ToLocalChecked()));
+        return;
+    }
+
+    // Paths are always taken from the root, with or without the leading slash
+    std::string path = *v8::String::Utf8Value(isolate, args[0]);
+    if (path.empty() || path[0] != '/')
+        path.insert(0, 1, '/');
+    int retval = NC_NOERR;
+    v8::Local<v8::Object> result = Group::resolve(isolate, obj->id, path, retval);
+    if (retval != NC_NOERR)
+        throw_netcdf_error(isolate, retval);
+    else if (!result.IsEmpty())
+        args.GetReturnValue().Set(result);
+}
 } // namespace nodenetcdfjs
@@ -1,6 +1,7 @@
 #ifndef NODENETCDFJS_FILE_H
 #define NODENETCDFJS_FILE_H
 
+#include <memory>
 #include <node.h>
 #include <node_object_wrap.h>
 
@@ -75,7 +76,8 @@ class File : public node::ObjectWrap
      * @brief Close the NetCDF file
      * @param args JavaScript function arguments
      * 
-     * Closes the file and releases associated resources.
+     * Closes the file and releases associated resources. A file created with the
+     * inMemory option returns its bytes as a Buffer that adopts the library's allocation.
      */
     static void Close(const v8::FunctionCallbackInfo<v8::Value> &args);
     
@@ -99,6 +101,24 @@ class File : public node::ObjectWrap
      */
     static void ToJSON(const v8::FunctionCallbackInfo<v8::Value> &args);
 
+    /**
+     * @brief Describe the whole file in one call
+     * @param args JavaScript function arguments: optional { json: boolean }
+     *
+     * Walks groups, dimensions, variables and attributes natively (see Metadata) without
+     * creating wrapper objects. Returns plain objects, or JSON text when json is true.
+     */
+    static void Describe(const v8::FunctionCallbackInfo<v8::Value> &args);
+
+    /**
+     * @brief Get a variable or group by path
+     * @param args JavaScript function arguments (path, e.g. '/forecast/ens03/u10')
+     *
+     * Paths are resolved from the root group with Group::resolve(), building only the
+     * wrapper that is returned. Returns undefined if nothing matches the path.
+     */
+    static void Get(const v8::FunctionCallbackInfo<v8::Value> &args);
+
     /// Persistent reference to the JavaScript constructor function
     static v8::Persistent<v8::Function> constructor;
 
@@ -107,6 +127,12 @@ class File : public node::ObjectWrap
     
     /// Flag indicating whether the file has been closed
     bool closed{false};
+
+    /// Memory of a file opened from a Buffer, kept alive until the file is closed
+    std::shared_ptr<v8::BackingStore> memory;
+
+    /// Whether the file was created in memory with nc_create_mem
+    bool in_memory{false};
 };
 
 } // namespace nodenetcdfjs
@@ -2,8 +2,12 @@
 #include "Attribute.h"
 #include "Dimension.h"
 #include "Variable.h"
+#include "WrapperCache.h"
 #include "nodenetcdfjs.h"
+#include <algorithm>
 #include <netcdf.h>
+#include <string>
+#include <utility>
 
 namespace nodenetcdfjs
 {
@@ -25,12 +29,15 @@ void Group::Init(v8::Local<v8::Object> exports)
     v8::Local<v8::FunctionTemplate> tpl = v8::FunctionTemplate::New(isolate);
     tpl->SetClassName(v8::String::NewFromUtf8(isolate, "Group", v8::NewStringType::kNormal).ToLocalChecked());
     tpl->InstanceTemplate()->SetInternalFieldCount(1);
-    NODE_SET_PROTOTYPE_METHOD(tpl, "addVariable", Group::AddVariable);
-    NODE_SET_PROTOTYPE_METHOD(tpl, "addDimension", Group::AddDimension);
-    NODE_SET_PROTOTYPE_METHOD(tpl, "addSubgroup", Group::AddSubgroup);
-    NODE_SET_PROTOTYPE_METHOD(tpl, "addAttribute", Group::AddAttribute);
-    NODE_SET_PROTOTYPE_METHOD(tpl, "inspect", Group::Inspect);
-    NODE_SET_PROTOTYPE_METHOD(tpl, "toJSON", Group::ToJSON);
+    NODE_SET_PROTOTYPE_METHOD(tpl, "addVariable", serialized<Group::AddVariable>);
+    NODE_SET_PROTOTYPE_METHOD(tpl, "addDimension", serialized<Group::AddDimension>);
+    NODE_SET_PROTOTYPE_METHOD(tpl, "addSubgroup", serialized<Group::AddSubgroup>);
+    NODE_SET_PROTOTYPE_METHOD(tpl, "addAttribute", serialized<Group::AddAttribute>);
+    NODE_SET_PROTOTYPE_METHOD(tpl, "readSlices", serialized<Group::ReadSlices>);
+    NODE_SET_PROTOTYPE_METHOD(tpl, "getVariable", serialized<Group::GetVariable>);
+    NODE_SET_PROTOTYPE_METHOD(tpl, "get", serialized<Group::Get>);
+    NODE_SET_PROTOTYPE_METHOD(tpl, "inspect", serialized<Group::Inspect>);
+    NODE_SET_PROTOTYPE_METHOD(tpl, "toJSON", serialized<Group::ToJSON>);
     tpl->InstanceTemplate()->SetAccessor(
         v8::String::NewFromUtf8(isolate, "id", v8::NewStringType::kNormal).ToLocalChecked(), Group::GetId);
     tpl->InstanceTemplate()->SetAccessor(
@@ -49,9 +56,11 @@ void Group::Init(v8::Local<v8::Object> exports)
         v8::String::NewFromUtf8(isolate, "subgroups", v8::NewStringType::kNormal).ToLocalChecked(),
         Group::GetSubgroups);
     tpl->InstanceTemplate()->SetAccessor(
-        v8::String::NewFromUtf8(isolate, "name", v8::NewStringType::kNormal).ToLocalChecked(), Group::GetName);
+        v8::String::NewFromUtf8(isolate, "name", v8::NewStringType::kNormal).ToLocalChecked(),
+        serialized<Group::GetName>);
     tpl->InstanceTemplate()->SetAccessor(
-        v8::String::NewFromUtf8(isolate, "fullname", v8::NewStringType::kNormal).ToLocalChecked(), Group::GetFullname);
+        v8::String::NewFromUtf8(isolate, "fullname", v8::NewStringType::kNormal).ToLocalChecked(),
+        serialized<Group::GetFullname>);
     constructor.Reset(isolate, tpl->GetFunction(isolate->GetCurrentContext()).ToLocalChecked());
 }
 
@@ -91,9 +100,104 @@ void Group::AddAttribute(const v8::FunctionCallbackInfo<v8::Value> &args)
 
     auto *res = new Attribute(*v8::String::Utf8Value(isolate, args[0]), NC_GLOBAL, obj->id, type);
     res->set_value(args[2]);
+    WrapperCache::set(isolate, WrapperCache::Kind::Attribute, obj->id, NC_GLOBAL, *v8::String::Utf8Value(isolate, args[0]),
+                      res->handle());
+    WrapperCache::erase(WrapperCache::Kind::Attributes, obj->id, NC_GLOBAL);
     args.GetReturnValue().Set(res->handle());
 }
 
+v8::Local<v8::Object> Group::resolve(v8::Isolate *isolate, int ncid, const std::string &path, int &retval)
+{
+    const size_t slash = path.find_last_of('/');
+    const std::string leaf = slash == std::string::npos ? path : path.substr(slash + 1);
+    const std::string parent = slash == std::string::npos ? std::string() : path.substr(0, slash);
+
+    int group_id = ncid;
+    retval = NC_NOERR;
+    if (!path.empty() && path[0] == '/')
+    {
+        // Full names resolve from any group of the file; only the root itself needs looking up
+        if (!parent.empty())
+            retval = nc_inq_grp_full_ncid(ncid, parent.c_str(), &group_id);
+        else
+            group_id = file_of(ncid);
+    }
+    else
+    {
+        for (size_t begin = 0; begin < parent.size() && retval == NC_NOERR;)
+        {
+            const size_t end = std::min(parent.find('/', begin), parent.size());
+            if (end > begin)
+                retval = nc_inq_grp_ncid(group_id, parent.substr(begin, end - begin).c_str(), &group_id);
+            begin = end + 1;
+        }
+    }
+
+    v8::Local<v8::Object> result;
+    int varid = -1;
+    if (retval == NC_NOERR && leaf.empty())
+        result = WrapperCache::lookup(isolate, WrapperCache::Kind::Group, group_id, 0, {},
+                                      [group_id] { return (new Group(group_id))->handle(); });
+    else if (retval == NC_NOERR && (retval = nc_inq_varid(group_id, leaf.c_str(), &varid)) == NC_NOERR)
+        result = WrapperCache::lookup(isolate, WrapperCache::Kind::Variable, group_id, varid, {},
+                                      [group_id, varid] { return (new Variable(varid, group_id))->handle(); });
+    else if (retval == NC_ENOTVAR && (retval = nc_inq_grp_ncid(group_id, leaf.c_str(), &group_id)) == NC_NOERR)
+        result = WrapperCache::lookup(isolate, WrapperCache::Kind::Group, group_id, 0, {},
+                                      [group_id] { return (new Group(group_id))->handle(); });
+
+    // A missing component is not an error; classic files have no subgroups to search
+    if (retval == NC_ENOTVAR || retval == NC_ENOGRP || retval == NC_ENOTNC4)
+        retval = NC_NOERR;
+    return result;
+}
+
+void Group::GetVariable(const v8::FunctionCallbackInfo<v8::Value> &args)
+{
+    v8::Isolate *isolate = args.GetIsolate();
+    const auto *obj = node::ObjectWrap::Unwrap<Group>(args.Holder());
+
+    if (args.Length() < 1 || !args[0]->IsString())
+    {
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8(isolate, "Expecting a variable name", v8::NewStringType::kNormal)
+                .ToLocalChecked()));
+        return;
+    }
+
+    int varid = -1;
+    const int retval = nc_inq_varid(obj->id, *v8::String::Utf8Value(isolate, args[0]), &varid);
+    if (retval == NC_ENOTVAR)
+        return;
+    if (retval != NC_NOERR)
+    {
+        throw_netcdf_error(isolate, retval);
+        return;
+    }
+    const int parent_id = obj->id;
+    args.GetReturnValue().Set(WrapperCache::lookup(isolate, WrapperCache::Kind::Variable, parent_id, varid, {},
+                                                   [&] { return (new Variable(varid, parent_id))->handle(); }));
+}
+
+void Group::Get(const v8::FunctionCallbackInfo<v8::Value> &args)
+{
+    v8::Isolate *isolate = args.GetIsolate();
+    const auto *obj = node::ObjectWrap::Unwrap<Group>(args.Holder());
+
+    if (args.Length() < 1 || !args[0]->IsString())
+    {
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8(isolate, "Expecting a path", v8::NewStringType::kNormal).ToLocalChecked()));
+        return;
+    }
+
+    int retval = NC_NOERR;
+    v8::Local<v8::Object> result = resolve(isolate, obj->id, *v8::String::Utf8Value(isolate, args[0]), retval);
+    if (retval != NC_NOERR)
+        throw_netcdf_error(isolate, retval);
+    else if (!result.IsEmpty())
+        args.GetReturnValue().Set(result);
+}
+
 void Group::AddSubgroup(const v8::FunctionCallbackInfo<v8::Value> &args)
 {
     v8::Isolate *isolate = args.GetIsolate();
@@ -117,6 +221,8 @@ void Group::AddSubgroup(const v8::FunctionCallbackInfo<v8::Value> &args)
     }
 
     auto *res = new Group(new_id);
+    WrapperCache::set(isolate, WrapperCache::Kind::Group, new_id, 0, {}, res->handle());
+    WrapperCache::erase(WrapperCache::Kind::Subgroups, obj->id, 0);
     args.GetReturnValue().Set(res->handle());
 }
 
@@ -157,6 +263,9 @@ void Group::AddDimension(const v8::FunctionCallbackInfo<v8::Value> &args)
     }
 
     auto *res = new Dimension(new_id, obj->id);
+    WrapperCache::set(isolate, WrapperCache::Kind::Dimension, obj->id, new_id, {}, res->handle());
+    WrapperCache::erase(WrapperCache::Kind::Dimensions, obj->id, 0);
+    WrapperCache::erase(WrapperCache::Kind::Unlimited, obj->id, 0);
     args.GetReturnValue().Set(res->handle());
 }
 
@@ -228,9 +337,162 @@ void Group::AddVariable(const v8::FunctionCallbackInfo<v8::Value> &args)
     }
 
     auto *res = new Variable(new_id, obj->id);
+    WrapperCache::set(isolate, WrapperCache::Kind::Variable, obj->id, new_id, {}, res->handle());
+    WrapperCache::erase(WrapperCache::Kind::Variables, obj->id, 0);
     args.GetReturnValue().Set(res->handle());
 }
 
+void Group::ReadSlices(const v8::FunctionCallbackInfo<v8::Value> &args)
+{
+    v8::Isolate *isolate = args.GetIsolate();
+    v8::Local<v8::Context> context = isolate->GetCurrentContext();
+    const auto *obj = node::ObjectWrap::Unwrap<Group>(args.Holder());
+
+    if (args.Length() < 1 || !args[0]->IsArray())
+    {
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8(isolate, "Group.readSlices(): Expecting an array of slice descriptors",
+                                    v8::NewStringType::kNormal)
+                .ToLocalChecked()));
+        return;
+    }
+    bool pack = false;
+    if (args.Length() > 1 && args[1]->IsObject())
+        pack = args[1]
+                   .As<v8::Object>()
+                   ->Get(context, v8::String::NewFromUtf8Literal(isolate, "pack"))
+                   .ToLocalChecked()
+                   ->BooleanValue(isolate);
+
+    struct Slice
+    {
+        Variable *variable{nullptr};
+        std::vector<size_t> start;
+        std::vector<size_t> count;
+        std::vector<ptrdiff_t> stride;
+        size_t length{1};
+        size_t byte_offset{0};
+    };
+
+    v8::Local<v8::Array> descriptors = args[0].As<v8::Array>();
+    std::vector<Slice> slices(descriptors->Length());
+    char error_msg[512];
+    const auto fail = [&](uint32_t i, const char *what) {
+        snprintf(error_msg, sizeof(error_msg), "Group.readSlices(): Descriptor %u: %s", i, what);
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8(isolate, error_msg, v8::NewStringType::kNormal).ToLocalChecked()));
+    };
+
+    for (uint32_t i = 0; i < slices.size(); i++)
+    {
+        v8::Local<v8::Value> item = descriptors->Get(context, i).ToLocalChecked();
+        if (!item->IsObject())
+        {
+            fail(i, "Expecting an object {variable, start, count[, stride]}");
+            return;
+        }
+        v8::Local<v8::Object> descriptor = item.As<v8::Object>();
+        Slice &slice = slices[i];
+
+        v8::Local<v8::Value> variable =
+            descriptor->Get(context, v8::String::NewFromUtf8Literal(isolate, "variable")).ToLocalChecked();
+        if (variable->IsString())
+        {
+            int varid = -1;
+            if (const int retval = nc_inq_varid(obj->id, *v8::String::Utf8Value(isolate, variable), &varid);
+                retval != NC_NOERR)
+            {
+                throw_netcdf_error(isolate, retval);
+                return;
+            }
+            variable = WrapperCache::lookup(isolate, WrapperCache::Kind::Variable, obj->id, varid, {},
+                                            [&] { return (new Variable(varid, obj->id))->handle(); });
+        }
+        slice.variable = Variable::unwrap(isolate, variable);
+        if (slice.variable == nullptr)
+        {
+            fail(i, "'variable' must be a Variable or the name of a variable in this group");
+            return;
+        }
+        if (slice.variable->element_size() == 0)
+        {
+            fail(i, "Variable type not supported for read operations");
+            return;
+        }
+
+        const int ndims = slice.variable->get_ndims();
+        const auto get_indices = [&](const char *key, auto &out, bool optional) {
+            v8::Local<v8::Value> value =
+                descriptor->Get(context, v8::String::NewFromUtf8(isolate, key).ToLocalChecked()).ToLocalChecked();
+            if (optional && value->IsUndefined())
+                return true;
+            if (!value->IsArray() || value.As<v8::Array>()->Length() != static_cast<uint32_t>(ndims))
+                return false;
+            out.resize(ndims);
+            for (int d = 0; d < ndims; d++)
+                out[d] = static_cast<std::remove_reference_t<decltype(out[d])>>(
+                    value.As<v8::Array>()->Get(context, d).ToLocalChecked()->IntegerValue(context).ToChecked());
+            return true;
+        };
+        if (!get_indices("start", slice.start, false) || !get_indices("count", slice.count, false) ||
+            !get_indices("stride", slice.stride, true))
+        {
+            fail(i, "'start', 'count' and 'stride' must be arrays with one entry per dimension");
+            return;
+        }
+        for (const size_t c : slice.count)
+            slice.length *= c;
+    }
+
+    // Visit the slices in file order (group, variable ID, then start) so neighbouring reads hit warm chunks
+    std::vector<size_t> order(slices.size());
+    for (size_t i = 0; i < order.size(); i++)
+        order[i] = i;
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        const Slice &sa = slices[a];
+        const Slice &sb = slices[b];
+        const auto key_a = std::make_pair(sa.variable->get_parent_id(), sa.variable->get_id());
+        const auto key_b = std::make_pair(sb.variable->get_parent_id(), sb.variable->get_id());
+        if (key_a != key_b)
+            return key_a < key_b;
+        return sa.start < sb.start;
+    });
+
+    v8::Local<v8::ArrayBuffer> packed;
+    if (pack)
+    {
+        size_t total = 0;
+        for (Slice &slice : slices)
+        {
+            // 8-byte alignment keeps every view valid whatever its element type
+            total = (total + 7) & ~size_t{7};
+            slice.byte_offset = total;
+            total += slice.length * slice.variable->element_size();
+        }
+        packed = v8::ArrayBuffer::New(isolate, total);
+    }
+
+    v8::Local<v8::Array> result = v8::Array::New(isolate, static_cast<int>(slices.size()));
+    for (const size_t i : order)
+    {
+        const Slice &slice = slices[i];
+        v8::Local<v8::ArrayBuffer> buffer =
+            pack ? packed : v8::ArrayBuffer::New(isolate, slice.length * slice.variable->element_size());
+        const int retval = slice.variable->read_slice(slice.start.data(), slice.count.data(),
+                                                      slice.stride.empty() ? nullptr : slice.stride.data(),
+                                                      static_cast<char *>(buffer->Data()) + slice.byte_offset);
+        if (retval != NC_NOERR)
+        {
+            throw_netcdf_error(isolate, retval);
+            return;
+        }
+        (void)result->Set(context, static_cast<uint32_t>(i),
+                          Variable::make_typed_array(slice.variable->get_element_type(), buffer, slice.byte_offset,
+                                                     slice.length));
+    }
+    args.GetReturnValue().Set(result);
+}
+
 void Group::GetId(v8::Local<v8::String> property, const v8::PropertyCallbackInfo<v8::Value> &info)
 {
     v8::Isolate *isolate = info.GetIsolate();
@@ -244,6 +506,15 @@ void Group::GetVariables(v8::Local<v8::String> property, const v8::PropertyCallb
     v8::Local<v8::Context> context = isolate->GetCurrentContext();
     const auto *obj = node::ObjectWrap::Unwrap<Group>(info.Holder());
 
+    if (v8::Local<v8::Object> cached = WrapperCache::get(isolate, WrapperCache::Kind::Variables, obj->id, 0);
+        !cached.IsEmpty())
+    {
+        info.GetReturnValue().Set(cached);
+        return;
+    }
+    // Only a miss reaches the library, so cache hits never wait for the I/O thread
+    const std::lock_guard<std::recursive_mutex> lock(netcdf_mutex());
+
     int nvars = 0;
     int retval = nc_inq_varids(obj->id, &nvars, nullptr);
     if (retval != NC_NOERR)
@@ -265,15 +536,18 @@ void Group::GetVariables(v8::Local<v8::String> property, const v8::PropertyCallb
 
     for (int i = 0; i < nvars; ++i)
     {
-        auto *v = new Variable(var_ids[i], obj->id);
-        if (v->get_name(name.data()))
+        v8::Local<v8::Object> handle =
+            WrapperCache::lookup(isolate, WrapperCache::Kind::Variable, obj->id, var_ids[i], {},
+                                 [&] { return (new Variable(var_ids[i], obj->id))->handle(); });
+        if (node::ObjectWrap::Unwrap<Variable>(handle)->get_name(name.data()))
             (void)result->CreateDataProperty(
                 context,
                 v8::String::NewFromUtf8(isolate, name.data(), v8::NewStringType::kInternalized).ToLocalChecked(),
-                v->handle());
+                handle);
         else
             return;
     }
+    WrapperCache::set(isolate, WrapperCache::Kind::Variables, obj->id, 0, {}, result);
     info.GetReturnValue().Set(result);
 }
 
@@ -283,6 +557,15 @@ void Group::GetDimensions(v8::Local<v8::String> property, const v8::PropertyCall
     v8::Local<v8::Context> context = isolate->GetCurrentContext();
     const auto *obj = node::ObjectWrap::Unwrap<Group>(info.Holder());
 
+    if (v8::Local<v8::Object> cached = WrapperCache::get(isolate, WrapperCache::Kind::Dimensions, obj->id, 0);
+        !cached.IsEmpty())
+    {
+        info.GetReturnValue().Set(cached);
+        return;
+    }
+    // Only a miss reaches the library, so cache hits never wait for the I/O thread
+    const std::lock_guard<std::recursive_mutex> lock(netcdf_mutex());
+
     int ndims = 0;
     int retval = nc_inq_dimids(obj->id, &ndims, nullptr, 0);
     if (retval != NC_NOERR)
@@ -304,17 +587,20 @@ void Group::GetDimensions(v8::Local<v8::String> property, const v8::PropertyCall
 
     for (int i = 0; i < ndims; ++i)
     {
-        auto *d = new Dimension(dim_ids[i], obj->id);
-        if (d->get_name(name.data()))
+        v8::Local<v8::Object> handle =
+            WrapperCache::lookup(isolate, WrapperCache::Kind::Dimension, obj->id, dim_ids[i], {},
+                                 [&] { return (new Dimension(dim_ids[i], obj->id))->handle(); });
+        if (node::ObjectWrap::Unwrap<Dimension>(handle)->get_name(name.data()))
         {
             (void)result->CreateDataProperty(
                 context,
                 v8::String::NewFromUtf8(isolate, name.data(), v8::NewStringType::kInternalized).ToLocalChecked(),
-                d->handle());
+                handle);
         }
         else
             return;
     }
+    WrapperCache::set(isolate, WrapperCache::Kind::Dimensions, obj->id, 0, {}, result);
     info.GetReturnValue().Set(result);
 }
 
@@ -324,6 +610,15 @@ void Group::GetUnlimited(v8::Local<v8::String> property, const v8::PropertyCallb
     v8::Local<v8::Context> context = isolate->GetCurrentContext();
     const auto *obj = node::ObjectWrap::Unwrap<Group>(info.Holder());
 
+    if (v8::Local<v8::Object> cached = WrapperCache::get(isolate, WrapperCache::Kind::Unlimited, obj->id, 0);
+        !cached.IsEmpty())
+    {
+        info.GetReturnValue().Set(cached);
+        return;
+    }
+    // Only a miss reaches the library, so cache hits never wait for the I/O thread
+    const std::lock_guard<std::recursive_mutex> lock(netcdf_mutex());
+
     int ndims = 0;
     int retval = nc_inq_unlimdims(obj->id, &ndims, nullptr);
     if (retval != NC_NOERR)
@@ -345,17 +640,20 @@ void Group::GetUnlimited(v8::Local<v8::String> property, const v8::PropertyCallb
 
     for (int i = 0; i < ndims; ++i)
     {
-        auto *d = new Dimension(dim_ids[i], obj->id);
-        if (d->get_name(name.data()))
+        v8::Local<v8::Object> handle =
+            WrapperCache::lookup(isolate, WrapperCache::Kind::Dimension, obj->id, dim_ids[i], {},
+                                 [&] { return (new Dimension(dim_ids[i], obj->id))->handle(); });
+        if (node::ObjectWrap::Unwrap<Dimension>(handle)->get_name(name.data()))
         {
             (void)result->CreateDataProperty(
                 context,
                 v8::String::NewFromUtf8(isolate, name.data(), v8::NewStringType::kInternalized).ToLocalChecked(),
-                d->handle());
+                handle);
         }
         else
             return;
     }
+    WrapperCache::set(isolate, WrapperCache::Kind::Unlimited, obj->id, 0, {}, result);
     info.GetReturnValue().Set(result);
 }
 
@@ -365,6 +663,16 @@ void Group::GetAttributes(v8::Local<v8::String> property, const v8::PropertyCall
     v8::Local<v8::Context> context = isolate->GetCurrentContext();
     const auto *obj = node::ObjectWrap::Unwrap<Group>(info.Holder());
 
+    if (v8::Local<v8::Object> cached =
+            WrapperCache::get(isolate, WrapperCache::Kind::Attributes, obj->id, NC_GLOBAL);
+        !cached.IsEmpty())
+    {
+        info.GetReturnValue().Set(cached);
+        return;
+    }
+    // Only a miss reaches the library, so cache hits never wait for the I/O thread
+    const std::lock_guard<std::recursive_mutex> lock(netcdf_mutex());
+
     int natts = 0;
     int retval = nc_inq_natts(obj->id, &natts);
     if (retval != NC_NOERR)
@@ -384,11 +692,14 @@ void Group::GetAttributes(v8::Local<v8::String> property, const v8::PropertyCall
             throw_netcdf_error(isolate, retval);
             return;
         }
-        auto *a = new Attribute(name.data(), NC_GLOBAL, obj->id);
+        v8::Local<v8::Object> handle =
+            WrapperCache::lookup(isolate, WrapperCache::Kind::Attribute, obj->id, NC_GLOBAL, name.data(),
+                                 [&] { return (new Attribute(name.data(), NC_GLOBAL, obj->id))->handle(); });
         (void)result->CreateDataProperty(
             context, v8::String::NewFromUtf8(isolate, name.data(), v8::NewStringType::kInternalized).ToLocalChecked(),
-            a->handle());
+            handle);
     }
+    WrapperCache::set(isolate, WrapperCache::Kind::Attributes, obj->id, NC_GLOBAL, {}, result);
     info.GetReturnValue().Set(result);
 }
 
@@ -398,6 +709,16 @@ void Group::GetSubgroups(v8::Local<v8::String> property, const v8::PropertyCallb
     v8::Local<v8::Context> context = isolate->GetCurrentContext();
     const auto *obj = node::ObjectWrap::Unwrap<Group>(info.Holder());
 
+    if (v8::Local<v8::Object> cached =
+            WrapperCache::get(isolate, WrapperCache::Kind::Subgroups, obj->id, 0);
+        !cached.IsEmpty())
+    {
+        info.GetReturnValue().Set(cached);
+        return;
+    }
+    // Only a miss reaches the library, so cache hits never wait for the I/O thread
+    const std::lock_guard<std::recursive_mutex> lock(netcdf_mutex());
+
     int ngrps = 0;
     int retval = nc_inq_grps(obj->id, &ngrps, nullptr);
     if (retval != NC_NOERR)
@@ -419,17 +740,19 @@ void Group::GetSubgroups(v8::Local<v8::String> property, const v8::PropertyCallb
 
     for (int i = 0; i < ngrps; ++i)
     {
-        auto *g = new Group(grp_ids[i]);
-        if (g->get_name(name.data()))
+        v8::Local<v8::Object> handle = WrapperCache::lookup(isolate, WrapperCache::Kind::Group, grp_ids[i], 0, {},
+                                                            [&] { return (new Group(grp_ids[i]))->handle(); });
+        if (node::ObjectWrap::Unwrap<Group>(handle)->get_name(name.data()))
         {
             (void)result->CreateDataProperty(
                 context,
                 v8::String::NewFromUtf8(isolate, name.data(), v8::NewStringType::kInternalized).ToLocalChecked(),
-                g->handle());
+                handle);
         }
         else
             return;
     }
+    WrapperCache::set(isolate, WrapperCache::Kind::Subgroups, obj->id, 0, {}, result);
     info.GetReturnValue().Set(result);
 }
 
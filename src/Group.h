@@ -3,6 +3,7 @@
 
 #include <node.h>
 #include <node_object_wrap.h>
+#include <string>
 
 namespace nodenetcdfjs
 {
@@ -49,6 +50,21 @@ class Group : public node::ObjectWrap
      */
     [[nodiscard]] bool get_name(char *name) const noexcept;
 
+    /**
+     * @brief Resolve a path to a variable or group wrapper
+     * @param isolate The V8 isolate
+     * @param ncid The group relative paths start from; absolute paths start from the root
+     * @param path Slash-separated path; the last component names a variable or, failing
+     *             that, a subgroup
+     * @param retval Set to the NetCDF error code on failure
+     * @return The wrapper, or an empty handle if nothing matches the path or on failure
+     *
+     * Only the wrappers on the way are created (through the wrapper cache); the variables
+     * and subgroups maps of the groups on the path are never built.
+     */
+    [[nodiscard]] static v8::Local<v8::Object> resolve(v8::Isolate *isolate, int ncid, const std::string &path,
+                                                      int &retval);
+
   private:
     // Delete copy and move operations for safety
     Group(const Group &) = delete;
@@ -160,6 +176,34 @@ class Group : public node::ObjectWrap
      */
     static void AddVariable(const v8::FunctionCallbackInfo<v8::Value> &args);
     
+    /**
+     * @brief Read several hyperslabs in one call
+     * @param args JavaScript function arguments (array of {variable, start, count, stride?} descriptors,
+     *             optional {pack} options)
+     *
+     * Variables may be given as Variable objects or as names of variables in this group. The slices
+     * are read in file order and returned as an array of typed arrays in descriptor order. With
+     * pack set, all results are views into one ArrayBuffer at 8-byte aligned offsets.
+     */
+    static void ReadSlices(const v8::FunctionCallbackInfo<v8::Value> &args);
+
+    /**
+     * @brief Get one variable of this group by name
+     * @param args JavaScript function arguments (name)
+     *
+     * Looks the variable up with nc_inq_varid() instead of building the variables map.
+     * Returns undefined if the group has no such variable.
+     */
+    static void GetVariable(const v8::FunctionCallbackInfo<v8::Value> &args);
+
+    /**
+     * @brief Get a variable or group by path
+     * @param args JavaScript function arguments (path, relative to this group or absolute)
+     *
+     * See resolve(). Returns undefined if nothing matches the path.
+     */
+    static void Get(const v8::FunctionCallbackInfo<v8::Value> &args);
+
     /**
      * @brief Custom inspect method for Node.js console output
      * @param args JavaScript function arguments
@@ -0,0 +1,359 @@
+#include "MappedFile.h"
+#include "nodenetcdfjs.h"
+#include <bit>
+#include <cstring>
+#include <utility>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace nodenetcdfjs
+{
+
+namespace
+{
+
+/// Header tags of the classic formats
+constexpr uint32_t nc_dimension_tag = 0x0A;
+constexpr uint32_t nc_variable_tag = 0x0B;
+constexpr uint32_t nc_attribute_tag = 0x0C;
+
+/**
+ * @brief Size in bytes of a value of an external type in a classic format file
+ * @return The size, or 0 for types the classic formats cannot hold
+ */
+constexpr size_t external_size(nc_type type) noexcept
+{
+    switch (type)
+    {
+    case NC_BYTE:
+    case NC_CHAR:
+    case NC_UBYTE:
+        return 1;
+    case NC_SHORT:
+    case NC_USHORT:
+        return 2;
+    case NC_INT:
+    case NC_UINT:
+    case NC_FLOAT:
+        return 4;
+    case NC_DOUBLE:
+    case NC_INT64:
+    case NC_UINT64:
+        return 8;
+    default:
+        return 0;
+    }
+}
+
+constexpr uint16_t byteswap(uint16_t value) noexcept
+{
+    return static_cast<uint16_t>((value << 8) | (value >> 8));
+}
+
+constexpr uint32_t byteswap(uint32_t value) noexcept
+{
+    return ((value & 0x000000FFu) << 24) | ((value & 0x0000FF00u) << 8) | ((value & 0x00FF0000u) >> 8) |
+           ((value & 0xFF000000u) >> 24);
+}
+
+constexpr uint64_t byteswap(uint64_t value) noexcept
+{
+    return (static_cast<uint64_t>(byteswap(static_cast<uint32_t>(value))) << 32) |
+           byteswap(static_cast<uint32_t>(value >> 32));
+}
+
+/**
+ * @brief Copy big-endian values into native order
+ *
+ * A plain loop over fixed-size words, vectorized like unpack_values() in Variable.cpp.
+ */
+template <typename Word> void swap_copy(const uint8_t *source, uint8_t *target, size_t length) noexcept
+{
+    for (size_t i = 0; i < length; i++)
+    {
+        Word word;
+        memcpy(&word, source + i * sizeof(Word), sizeof(Word));
+        word = byteswap(word);
+        memcpy(target + i * sizeof(Word), &word, sizeof(Word));
+    }
+}
+
+/// Bounds-checked reader of big-endian header fields
+struct Cursor
+{
+    const uint8_t *data;
+    size_t size;
+    size_t offset{0};
+    bool failed{false};
+
+    uint64_t read(size_t bytes) noexcept
+    {
+        if (failed || size - offset < bytes)
+        {
+            failed = true;
+            return 0;
+        }
+        uint64_t value = 0;
+        for (size_t i = 0; i < bytes; i++)
+            value = (value << 8) | data[offset + i];
+        offset += bytes;
+        return value;
+    }
+
+    void skip(uint64_t bytes) noexcept
+    {
+        // Values are padded to a 4-byte boundary
+        bytes = (bytes + 3) & ~uint64_t{3};
+        if (failed || size - offset < bytes)
+            failed = true;
+        else
+            offset += static_cast<size_t>(bytes);
+    }
+};
+
+} // namespace
+
+std::unordered_map<int, std::shared_ptr<MappedFile>> &MappedFile::files() noexcept
+{
+    static std::unordered_map<int, std::shared_ptr<MappedFile>> files;
+    return files;
+}
+
+std::shared_ptr<MappedFile> MappedFile::open(const std::string &path)
+{
+    std::shared_ptr<MappedFile> file(new MappedFile());
+#ifdef _WIN32
+    const int wide_length = MultiByteToWideChar(CP_UTF8, 0, path.c_str(), -1, nullptr, 0);
+    std::wstring wide_path(wide_length > 0 ? wide_length : 0, L'\0');
+    MultiByteToWideChar(CP_UTF8, 0, path.c_str(), -1, wide_path.data(), wide_length);
+    HANDLE handle = CreateFileW(wide_path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (handle == INVALID_HANDLE_VALUE)
+        return nullptr;
+    LARGE_INTEGER length;
+    if (GetFileSizeEx(handle, &length) && length.QuadPart > 0)
+    {
+        // The mapping object stays valid after the file handle is closed; views are copy-on-write
+        file->mapping = CreateFileMappingW(handle, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+        if (file->mapping != nullptr)
+        {
+            file->data = static_cast<uint8_t *>(MapViewOfFile(file->mapping, FILE_MAP_READ, 0, 0, 0));
+            if (file->data != nullptr)
+                file->size = static_cast<size_t>(length.QuadPart);
+        }
+    }
+    CloseHandle(handle);
+#else
+    // The descriptor stays open to map the pages of each view
+    file->descriptor = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (file->descriptor < 0)
+        return nullptr;
+    struct stat status;
+    if (fstat(file->descriptor, &status) == 0 && status.st_size > 0)
+    {
+        void *mapped = mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ, MAP_PRIVATE, file->descriptor, 0);
+        if (mapped != MAP_FAILED)
+        {
+            file->data = static_cast<uint8_t *>(mapped);
+            file->size = static_cast<size_t>(status.st_size);
+        }
+    }
+#endif
+    if (file->data == nullptr || !file->parse())
+        return nullptr;
+    return file;
+}
+
+MappedFile::~MappedFile()
+{
+#ifdef _WIN32
+    if (data != nullptr)
+        UnmapViewOfFile(data);
+    if (mapping != nullptr)
+        CloseHandle(mapping);
+#else
+    if (data != nullptr)
+        munmap(data, size);
+    if (descriptor >= 0)
+        close(descriptor);
+#endif
+}
+
+bool MappedFile::parse()
+{
+    Cursor cursor{data, size};
+    if (cursor.read(3) != 0x434446) // "CDF"
+        return false;
+    const uint64_t version = cursor.read(1);
+    if (version != 1 && version != 2 && version != 5)
+        return false;
+    // CDF5 widens counts and lengths to 64 bits, the 64-bit offset format only offsets
+    const size_t count_bytes = version == 5 ? 8 : 4;
+    const size_t offset_bytes = version == 1 ? 4 : 8;
+    (void)cursor.read(count_bytes); // numrecs
+
+    std::vector<uint64_t> dimensions;
+    const auto read_name = [&cursor, count_bytes] { cursor.skip(cursor.read(count_bytes)); };
+    const auto read_list = [&cursor, count_bytes](uint32_t tag) -> uint64_t {
+        const uint64_t found = cursor.read(4);
+        const uint64_t length = cursor.read(count_bytes);
+        if (found != tag && (found != 0 || length != 0))
+            cursor.failed = true;
+        return cursor.failed ? 0 : length;
+    };
+    const auto skip_attributes = [&] {
+        const uint64_t length = read_list(nc_attribute_tag);
+        for (uint64_t i = 0; i < length && !cursor.failed; i++)
+        {
+            read_name();
+            const size_t value_size = external_size(static_cast<nc_type>(cursor.read(4)));
+            const uint64_t values = cursor.read(count_bytes);
+            if (value_size == 0 || values > size / value_size)
+                cursor.failed = true;
+            else
+                cursor.skip(values * value_size);
+        }
+    };
+
+    const uint64_t ndims = read_list(nc_dimension_tag);
+    for (uint64_t i = 0; i < ndims && !cursor.failed; i++)
+    {
+        read_name();
+        dimensions.push_back(cursor.read(count_bytes));
+    }
+    skip_attributes();
+
+    const uint64_t nvars = read_list(nc_variable_tag);
+    for (uint64_t i = 0; i < nvars && !cursor.failed; i++)
+    {
+        Layout layout;
+        read_name();
+        const uint64_t rank = cursor.read(count_bytes);
+        for (uint64_t d = 0; d < rank && !cursor.failed; d++)
+        {
+            const uint64_t dimension = cursor.read(count_bytes);
+            if (dimension >= dimensions.size())
+                cursor.failed = true;
+            else if (dimensions[dimension] == 0)
+                layout.record = true;
+            else
+                layout.shape.push_back(static_cast<size_t>(dimensions[dimension]));
+        }
+        skip_attributes();
+        layout.type = static_cast<nc_type>(cursor.read(4));
+        (void)cursor.read(count_bytes); // vsize
+        layout.begin = cursor.read(offset_bytes);
+        variables.push_back(std::move(layout));
+    }
+    return !cursor.failed;
+}
+
+void MappedFile::attach(int ncid, std::shared_ptr<MappedFile> file)
+{
+    files()[file_of(ncid)] = std::move(file);
+}
+
+void MappedFile::detach(int ncid)
+{
+    files().erase(file_of(ncid));
+}
+
+std::shared_ptr<MappedFile> MappedFile::find(int ncid)
+{
+    auto &mapped = files();
+    if (mapped.empty())
+        return nullptr;
+    auto it = mapped.find(file_of(ncid));
+    return it == mapped.end() ? nullptr : it->second;
+}
+
+std::shared_ptr<v8::BackingStore> MappedFile::view(int var_id, const size_t *start, const size_t *count)
+{
+    if (var_id < 0 || static_cast<size_t>(var_id) >= variables.size())
+        return nullptr;
+    const Layout &layout = variables[var_id];
+    const size_t element_size = external_size(layout.type);
+    if (layout.record || element_size == 0)
+        return nullptr;
+
+    // The hyperslab is contiguous if it spans whole trailing dimensions, one partial
+    // dimension and single indices before it
+    const size_t ndims = layout.shape.size();
+    size_t split = ndims;
+    while (split > 0 && start[split - 1] == 0 && count[split - 1] == layout.shape[split - 1])
+        split--;
+    uint64_t offset = 0;
+    uint64_t length = 1;
+    for (size_t d = 0; d < ndims; d++)
+    {
+        if (start[d] + count[d] > layout.shape[d] || (d + 1 < split && count[d] != 1))
+            return nullptr;
+        offset = offset * layout.shape[d] + start[d];
+        length *= count[d];
+    }
+    offset = layout.begin + offset * element_size;
+    length *= element_size;
+    if (length == 0 || offset > size || length > size - offset)
+        return nullptr;
+
+    if (element_size == 1 || (std::endian::native == std::endian::big && offset % element_size == 0))
+        return map_view(offset, static_cast<size_t>(length));
+
+    const uint8_t *source = data + offset;
+    std::unique_ptr<v8::BackingStore> store =
+        v8::ArrayBuffer::NewBackingStore(v8::Isolate::GetCurrent(), static_cast<size_t>(length));
+    auto *target = static_cast<uint8_t *>(store->Data());
+    const size_t values = static_cast<size_t>(length) / element_size;
+    if (std::endian::native == std::endian::big)
+        memcpy(target, source, static_cast<size_t>(length));
+    else if (element_size == 2)
+        swap_copy<uint16_t>(source, target, values);
+    else if (element_size == 4)
+        swap_copy<uint32_t>(source, target, values);
+    else
+        swap_copy<uint64_t>(source, target, values);
+    return store;
+}
+
+std::shared_ptr<v8::BackingStore> MappedFile::map_view(uint64_t offset, size_t length)
+{
+    // Map the covering pages privately, so that writes to one array reach neither the others nor later reads
+#ifdef _WIN32
+    SYSTEM_INFO system;
+    GetSystemInfo(&system);
+    const uint64_t aligned = offset - offset % system.dwAllocationGranularity;
+    const size_t span = static_cast<size_t>(offset - aligned) + length;
+    void *base = MapViewOfFile(mapping, FILE_MAP_COPY, static_cast<DWORD>(aligned >> 32),
+                               static_cast<DWORD>(aligned & 0xFFFFFFFF), span);
+    if (base == nullptr)
+        return nullptr;
+    return v8::ArrayBuffer::NewBackingStore(
+        static_cast<uint8_t *>(base) + (offset - aligned), length,
+        [](void *, size_t, void *deleter_data) { UnmapViewOfFile(deleter_data); }, base);
+#else
+    const auto page = static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+    const uint64_t aligned = offset - offset % page;
+    const size_t span = static_cast<size_t>(offset - aligned) + length;
+    void *base = mmap(nullptr, span, PROT_READ | PROT_WRITE, MAP_PRIVATE, descriptor, static_cast<off_t>(aligned));
+    if (base == MAP_FAILED)
+        return nullptr;
+    // The store owns its pages, which stay valid after the file is closed
+    auto *region = new std::pair<void *, size_t>(base, span);
+    return v8::ArrayBuffer::NewBackingStore(
+        static_cast<uint8_t *>(base) + (offset - aligned), length,
+        [](void *, size_t, void *deleter_data) {
+            auto *region = static_cast<std::pair<void *, size_t> *>(deleter_data);
+            munmap(region->first, region->second);
+            delete region;
+        },
+        region);
+#endif
+}
+
+} // namespace nodenetcdfjs
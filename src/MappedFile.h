@@ -0,0 +1,138 @@
+#ifndef NODENETCDFJS_MAPPEDFILE_H
+#define NODENETCDFJS_MAPPEDFILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <netcdf.h>
+#include <node.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace nodenetcdfjs
+{
+
+/**
+ * @brief Read-only memory mapping of a classic, 64-bit offset or CDF5 file
+ *
+ * Fixed-size variables of these formats are stored contiguously, in big-endian order,
+ * at an offset recorded in the file header. The header is parsed once when the file is
+ * mapped, so contiguous hyperslabs can be served straight from the mapping instead of
+ * going through nc_get_vara(). When the on-disk bytes are already in native order the
+ * returned backing store points into the mapping itself; otherwise the bytes are swapped
+ * into a fresh buffer in a single pass.
+ *
+ * Each array handed out by view() without a copy gets its own copy-on-write mapping of
+ * the pages it covers: writing to it modifies a private copy, never the file, other
+ * arrays or later reads. Its backing store owns those pages until it is garbage
+ * collected, even after the file is closed.
+ */
+class MappedFile
+{
+  public:
+    /**
+     * @brief Map a file and parse its header
+     * @param path Path of the file
+     * @return The mapping, or nullptr if the file cannot be mapped or is not a classic format file
+     */
+    [[nodiscard]] static std::shared_ptr<MappedFile> open(const std::string &path);
+
+    /**
+     * @brief Register the mapping of an open file
+     * @param ncid ID of the file
+     * @param file The mapping
+     */
+    static void attach(int ncid, std::shared_ptr<MappedFile> file);
+
+    /**
+     * @brief Forget the mapping of a file being closed
+     * @param ncid ID of the file
+     *
+     * Arrays still viewing the mapping keep it alive.
+     */
+    static void detach(int ncid);
+
+    /**
+     * @brief Find the mapping of the file that contains a group
+     * @param ncid Group or file ID
+     * @return The mapping, or nullptr if the file is not mapped
+     */
+    [[nodiscard]] static std::shared_ptr<MappedFile> find(int ncid);
+
+    /**
+     * @brief Get the bytes of a hyperslab of a variable in native order
+     * @param var_id The variable ID
+     * @param start Start of the hyperslab for each dimension
+     * @param count Extent of the hyperslab for each dimension
+     * @return A backing store holding the values, or nullptr if the hyperslab cannot be
+     *         served from the mapping (record variable, non-contiguous or empty hyperslab,
+     *         data beyond the end of the file)
+     */
+    [[nodiscard]] std::shared_ptr<v8::BackingStore> view(int var_id, const size_t *start, const size_t *count);
+
+    ~MappedFile();
+
+  private:
+    MappedFile() = default;
+
+    // Delete copy and move operations for safety
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+    MappedFile(MappedFile &&) = delete;
+    MappedFile &operator=(MappedFile &&) = delete;
+
+    /// Storage of a variable as recorded in the file header
+    struct Layout
+    {
+        /// The NetCDF type of the variable
+        nc_type type{NC_NAT};
+
+        /// Length of each dimension
+        std::vector<size_t> shape;
+
+        /// Offset of the first value in the file
+        uint64_t begin{0};
+
+        /// Whether the variable has the record dimension, and so is not contiguous
+        bool record{false};
+    };
+
+    /**
+     * @brief Parse the header of the mapped file
+     * @return Whether the header is a valid classic, 64-bit offset or CDF5 header
+     */
+    [[nodiscard]] bool parse();
+
+    /**
+     * @brief Map a byte range of the file into a private, writable backing store
+     * @param offset Offset of the range in the file
+     * @param length Length of the range in bytes
+     * @return The backing store, or nullptr if the range cannot be mapped
+     */
+    [[nodiscard]] std::shared_ptr<v8::BackingStore> map_view(uint64_t offset, size_t length);
+
+    /// Per-file mappings, keyed by the ID of the root group, see file_of()
+    [[nodiscard]] static std::unordered_map<int, std::shared_ptr<MappedFile>> &files() noexcept;
+
+    /// Start of the mapping
+    uint8_t *data{nullptr};
+
+    /// Size of the mapping in bytes
+    size_t size{0};
+
+#ifdef _WIN32
+    /// File mapping object the views are mapped from
+    void *mapping{nullptr};
+#else
+    /// Descriptor of the file the views are mapped from
+    int descriptor{-1};
+#endif
+
+    /// Layout of every variable, indexed by variable ID
+    std::vector<Layout> variables;
+};
+
+} // namespace nodenetcdfjs
+
+#endif
@@ -0,0 +1,601 @@
+#include "Metadata.h"
+#include "UserType.h"
+#include "Variable.h"
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace nodenetcdfjs
+{
+
+namespace
+{
+
+/// Builds plain JavaScript objects and arrays
+class ObjectWriter
+{
+  public:
+    explicit ObjectWriter(v8::Isolate *isolate_)
+        : isolate(isolate_)
+        , context(isolate_->GetCurrentContext())
+    {
+    }
+
+    void begin_object()
+    {
+        v8::Local<v8::Object> object = v8::Object::New(isolate);
+        put(object);
+        stack.push_back({object, false, 0});
+    }
+
+    void end_object() noexcept
+    {
+        stack.pop_back();
+    }
+
+    void begin_array()
+    {
+        v8::Local<v8::Object> array = v8::Array::New(isolate);
+        put(array);
+        stack.push_back({array, true, 0});
+    }
+
+    void end_array() noexcept
+    {
+        stack.pop_back();
+    }
+
+    void key(const char *name)
+    {
+        pending_key = v8::String::NewFromUtf8(isolate, name, v8::NewStringType::kInternalized).ToLocalChecked();
+    }
+
+    void null()
+    {
+        put(v8::Null(isolate));
+    }
+
+    void boolean(bool value)
+    {
+        put(v8::Boolean::New(isolate, value));
+    }
+
+    void number(double value)
+    {
+        put(v8::Number::New(isolate, value));
+    }
+
+    void string(const char *value, size_t length)
+    {
+        put(v8::String::NewFromUtf8(isolate, value, v8::NewStringType::kNormal, static_cast<int>(length))
+                .ToLocalChecked());
+    }
+
+    v8::Local<v8::Value> result() const noexcept
+    {
+        return root;
+    }
+
+  private:
+    struct Frame
+    {
+        v8::Local<v8::Object> container;
+        bool array;
+        uint32_t length;
+    };
+
+    void put(v8::Local<v8::Value> value)
+    {
+        if (stack.empty())
+        {
+            root = value;
+            return;
+        }
+        Frame &frame = stack.back();
+        if (frame.array)
+            (void)frame.container->CreateDataProperty(context, frame.length++, value);
+        else
+            (void)frame.container->CreateDataProperty(context, pending_key, value);
+    }
+
+    v8::Isolate *isolate;
+    v8::Local<v8::Context> context;
+    std::vector<Frame> stack;
+    v8::Local<v8::String> pending_key;
+    v8::Local<v8::Value> root;
+};
+
+/// Appends JSON text, formatted like JSON.stringify() without indentation
+class JsonWriter
+{
+  public:
+    explicit JsonWriter(std::string &out_) noexcept
+        : out(out_)
+    {
+    }
+
+    void begin_object()
+    {
+        separate();
+        out += '{';
+        first.push_back(true);
+    }
+
+    void end_object()
+    {
+        out += '}';
+        first.pop_back();
+    }
+
+    void begin_array()
+    {
+        separate();
+        out += '[';
+        first.push_back(true);
+    }
+
+    void end_array()
+    {
+        out += ']';
+        first.pop_back();
+    }
+
+    void key(const char *name)
+    {
+        separate();
+        quote(name, strlen(name));
+        out += ':';
+        after_key = true;
+    }
+
+    void null()
+    {
+        separate();
+        out += "null";
+    }
+
+    void boolean(bool value)
+    {
+        separate();
+        out += value ? "true" : "false";
+    }
+
+    void number(double value)
+    {
+        separate();
+        // Like JSON.stringify(): no NaN or Infinity, and no negative zero
+        if (!std::isfinite(value))
+        {
+            out += "null";
+            return;
+        }
+        std::array<char, 32> buffer;
+        const auto result = std::to_chars(buffer.data(), buffer.data() + buffer.size(), value == 0 ? 0.0 : value);
+        out.append(buffer.data(), result.ptr);
+    }
+
+    void string(const char *value, size_t length)
+    {
+        separate();
+        quote(value, length);
+    }
+
+  private:
+    void separate()
+    {
+        if (after_key)
+        {
+            after_key = false;
+            return;
+        }
+        if (!first.empty())
+        {
+            if (!first.back())
+                out += ',';
+            first.back() = false;
+        }
+    }
+
+    void quote(const char *value, size_t length)
+    {
+        out += '"';
+        for (size_t i = 0; i < length; i++)
+        {
+            const auto c = static_cast<unsigned char>(value[i]);
+            switch (c)
+            {
+            case '"':
+                out += "\\\"";
+                break;
+            case '\\':
+                out += "\\\\";
+                break;
+            case '\n':
+                out += "\\n";
+                break;
+            case '\r':
+                out += "\\r";
+                break;
+            case '\t':
+                out += "\\t";
+                break;
+            default:
+                if (c < 0x20)
+                {
+                    char escape[7];
+                    snprintf(escape, sizeof(escape), "\\u%04x", c);
+                    out += escape;
+                }
+                else
+                    out += static_cast<char>(c);
+            }
+        }
+        out += '"';
+    }
+
+    std::string &out;
+
+    /// Whether the innermost container is still empty
+    std::vector<bool> first;
+
+    /// Whether a key was just written, so the next value needs no separator
+    bool after_key{false};
+};
+
+template <typename Writer> void write_string(Writer &writer, const char *value)
+{
+    if (value == nullptr)
+        writer.null();
+    else
+        writer.string(value, strlen(value));
+}
+
+/**
+ * @brief Emit one value of an atomic numeric type
+ *
+ * 64-bit integers are emitted as decimal strings to stay exact.
+ */
+template <typename Writer> void write_number(Writer &writer, nc_type type, const uint8_t *data)
+{
+    const auto load = [data]<typename T>(T) {
+        T value;
+        memcpy(&value, data, sizeof(T));
+        return value;
+    };
+    switch (type)
+    {
+    case NC_BYTE:
+        writer.number(load(int8_t{}));
+        break;
+    case NC_UBYTE:
+        writer.number(load(uint8_t{}));
+        break;
+    case NC_SHORT:
+        writer.number(load(int16_t{}));
+        break;
+    case NC_USHORT:
+        writer.number(load(uint16_t{}));
+        break;
+    case NC_INT:
+        writer.number(load(int32_t{}));
+        break;
+    case NC_UINT:
+        writer.number(load(uint32_t{}));
+        break;
+    case NC_FLOAT:
+        writer.number(load(float{}));
+        break;
+    case NC_DOUBLE:
+        writer.number(load(double{}));
+        break;
+    case NC_INT64:
+    case NC_UINT64: {
+        const std::string value =
+            type == NC_INT64 ? std::to_string(load(int64_t{})) : std::to_string(load(uint64_t{}));
+        writer.string(value.data(), value.size());
+        break;
+    }
+    default:
+        writer.null();
+    }
+}
+
+/// Size of a value of an atomic numeric type, 0 for other types
+constexpr size_t number_size(nc_type type) noexcept
+{
+    constexpr std::array<size_t, 12> sizes = {0, 1, 0, 2, 4, 4, 8, 1, 2, 4, 8, 8};
+    return type >= NC_NAT && type <= NC_UINT64 ? sizes[type] : 0;
+}
+
+template <typename Writer> int write_attribute(Writer &writer, int ncid, int varid, int index)
+{
+    char name[NC_MAX_NAME + 1] = {};
+    nc_type type = NC_NAT;
+    size_t length = 0;
+    int retval = nc_inq_attname(ncid, varid, index, name);
+    if (retval == NC_NOERR)
+        retval = nc_inq_att(ncid, varid, name, &type, &length);
+    if (retval != NC_NOERR)
+        return retval;
+
+    writer.begin_object();
+    writer.key("name");
+    writer.string(name, strlen(name));
+    writer.key("value");
+    if (type == NC_CHAR)
+    {
+        std::vector<char> text(length + 1, '\0');
+        retval = nc_get_att_text(ncid, varid, name, text.data());
+        write_string(writer, text.data());
+    }
+    else if (type == NC_STRING)
+    {
+        std::vector<char *> strings(length, nullptr);
+        retval = nc_get_att_string(ncid, varid, name, strings.data());
+        if (retval == NC_NOERR)
+        {
+            if (length == 1)
+                write_string(writer, strings[0]);
+            else
+            {
+                writer.begin_array();
+                for (const char *value : strings)
+                    write_string(writer, value);
+                writer.end_array();
+            }
+            (void)nc_free_string(length, strings.data());
+        }
+    }
+    else if (const size_t size = number_size(type); size > 0)
+    {
+        std::vector<uint8_t> values(length * size);
+        retval = nc_get_att(ncid, varid, name, values.data());
+        if (retval == NC_NOERR && length == 1)
+            write_number(writer, type, values.data());
+        else if (retval == NC_NOERR)
+        {
+            writer.begin_array();
+            for (size_t i = 0; i < length; i++)
+                write_number(writer, type, values.data() + i * size);
+            writer.end_array();
+        }
+    }
+    else
+        writer.null();
+    writer.end_object();
+    return retval;
+}
+
+template <typename Writer> int write_attributes(Writer &writer, int ncid, int varid, int natts)
+{
+    writer.begin_array();
+    int retval = NC_NOERR;
+    for (int i = 0; i < natts && retval == NC_NOERR; i++)
+        retval = write_attribute(writer, ncid, varid, i);
+    writer.end_array();
+    return retval;
+}
+
+/**
+ * @brief Emit a dimension
+ * @param unlimited Unlimited dimensions of the group, or nullptr to leave out the unlimited flag
+ */
+template <typename Writer>
+int write_dimension(Writer &writer, int ncid, int dimid, const std::vector<int> *unlimited = nullptr)
+{
+    char name[NC_MAX_NAME + 1] = {};
+    size_t length = 0;
+    const int retval = nc_inq_dim(ncid, dimid, name, &length);
+    if (retval != NC_NOERR)
+        return retval;
+    // Records buffered by appendRecords() are reported apart: readSlice() cannot reach them yet
+    const size_t buffered = Variable::buffered_length(ncid, dimid);
+    writer.begin_object();
+    writer.key("id");
+    writer.number(dimid);
+    writer.key("name");
+    writer.string(name, strlen(name));
+    writer.key("length");
+    writer.number(static_cast<double>(length));
+    if (buffered > length)
+    {
+        writer.key("bufferedLength");
+        writer.number(static_cast<double>(buffered));
+    }
+    if (unlimited != nullptr)
+    {
+        writer.key("unlimited");
+        writer.boolean(std::find(unlimited->begin(), unlimited->end(), dimid) != unlimited->end());
+    }
+    writer.end_object();
+    return NC_NOERR;
+}
+
+template <typename Writer> int write_variable(Writer &writer, int ncid, int varid)
+{
+    char name[NC_MAX_NAME + 1] = {};
+    nc_type type = NC_NAT;
+    int ndims = 0;
+    int natts = 0;
+    int retval = nc_inq_var(ncid, varid, name, &type, &ndims, nullptr, &natts);
+    if (retval != NC_NOERR)
+        return retval;
+    std::vector<int> dimids(ndims);
+    retval = nc_inq_var(ncid, varid, nullptr, nullptr, nullptr, dimids.data(), nullptr);
+    std::string type_name;
+    if (retval == NC_NOERR)
+        retval = UserType::name(ncid, type, type_name);
+    if (retval != NC_NOERR)
+        return retval;
+
+    writer.begin_object();
+    writer.key("id");
+    writer.number(varid);
+    writer.key("name");
+    writer.string(name, strlen(name));
+    writer.key("type");
+    writer.string(type_name.data(), type_name.size());
+    writer.key("dimensions");
+    writer.begin_array();
+    for (int d = 0; d < ndims && retval == NC_NOERR; d++)
+        retval = write_dimension(writer, ncid, dimids[d]);
+    writer.end_array();
+    if (retval == NC_NOERR)
+    {
+        writer.key("attributes");
+        retval = write_attributes(writer, ncid, varid, natts);
+    }
+
+    // Storage settings the format does not support are left out, as in toJSON()
+    int endianness = NC_ENDIAN_NATIVE;
+    if (retval == NC_NOERR && nc_inq_var_endian(ncid, varid, &endianness) == NC_NOERR)
+    {
+        writer.key("endianness");
+        const char *value = endianness == NC_ENDIAN_LITTLE ? "little"
+                            : endianness == NC_ENDIAN_BIG  ? "big"
+                                                           : "native";
+        write_string(writer, value);
+    }
+    int checksum = NC_NOCHECKSUM;
+    if (retval == NC_NOERR && nc_inq_var_fletcher32(ncid, varid, &checksum) == NC_NOERR)
+    {
+        writer.key("checksummode");
+        write_string(writer, checksum == NC_FLETCHER32 ? "fletcher32" : "none");
+    }
+    int storage = NC_CONTIGUOUS;
+    std::vector<size_t> chunk_sizes(ndims, 0);
+    if (retval == NC_NOERR && nc_inq_var_chunking(ncid, varid, &storage, chunk_sizes.data()) == NC_NOERR)
+    {
+        writer.key("chunkmode");
+        write_string(writer, storage == NC_CHUNKED ? "chunked" : storage == NC_COMPACT ? "compact" : "contiguous");
+        writer.key("chunksizes");
+        writer.begin_array();
+        for (size_t size : chunk_sizes)
+            writer.number(static_cast<double>(size));
+        writer.end_array();
+    }
+    int no_fill = 0;
+    alignas(8) std::array<uint8_t, 8> fill_value{};
+    const size_t fill_size = number_size(type);
+    if (retval == NC_NOERR &&
+        nc_inq_var_fill(ncid, varid, &no_fill, fill_size > 0 ? fill_value.data() : nullptr) == NC_NOERR)
+    {
+        writer.key("fillmode");
+        writer.boolean(no_fill == 1);
+        writer.key("fillvalue");
+        if (fill_size > 0)
+            write_number(writer, type, fill_value.data());
+        else
+            writer.null();
+    }
+    int shuffle = 0;
+    int deflate = 0;
+    int level = 0;
+    if (retval == NC_NOERR && nc_inq_var_deflate(ncid, varid, &shuffle, &deflate, &level) == NC_NOERR)
+    {
+        writer.key("compressionshuffle");
+        writer.boolean(shuffle == 1);
+        writer.key("compressiondeflate");
+        writer.boolean(deflate == 1);
+        writer.key("compressionlevel");
+        writer.number(level);
+    }
+    writer.end_object();
+    return retval;
+}
+
+template <typename Writer> int write_group(Writer &writer, int ncid)
+{
+    char name[NC_MAX_NAME + 1] = {};
+    size_t fullname_length = 0;
+    int retval = nc_inq_grpname(ncid, name);
+    if (retval == NC_NOERR)
+        retval = nc_inq_grpname_full(ncid, &fullname_length, nullptr);
+    std::vector<char> fullname(fullname_length + 1, '\0');
+    if (retval == NC_NOERR)
+        retval = nc_inq_grpname_full(ncid, nullptr, fullname.data());
+
+    int ndims = 0;
+    int nunlimited = 0;
+    int nvars = 0;
+    int natts = 0;
+    int ngroups = 0;
+    if (retval == NC_NOERR)
+        retval = nc_inq_dimids(ncid, &ndims, nullptr, 0);
+    if (retval == NC_NOERR)
+        retval = nc_inq_unlimdims(ncid, &nunlimited, nullptr);
+    if (retval == NC_NOERR)
+        retval = nc_inq_varids(ncid, &nvars, nullptr);
+    if (retval == NC_NOERR)
+        retval = nc_inq_natts(ncid, &natts);
+    if (retval == NC_NOERR)
+        retval = nc_inq_grps(ncid, &ngroups, nullptr);
+    std::vector<int> dimids(ndims);
+    std::vector<int> unlimited(nunlimited);
+    std::vector<int> varids(nvars);
+    std::vector<int> groups(ngroups);
+    if (retval == NC_NOERR && ndims > 0)
+        retval = nc_inq_dimids(ncid, nullptr, dimids.data(), 0);
+    if (retval == NC_NOERR && nunlimited > 0)
+        retval = nc_inq_unlimdims(ncid, nullptr, unlimited.data());
+    if (retval == NC_NOERR && nvars > 0)
+        retval = nc_inq_varids(ncid, nullptr, varids.data());
+    if (retval == NC_NOERR && ngroups > 0)
+        retval = nc_inq_grps(ncid, nullptr, groups.data());
+    if (retval != NC_NOERR)
+        return retval;
+
+    writer.begin_object();
+    writer.key("id");
+    writer.number(ncid);
+    writer.key("name");
+    writer.string(name, strlen(name));
+    writer.key("fullname");
+    writer.string(fullname.data(), strlen(fullname.data()));
+    writer.key("dimensions");
+    writer.begin_array();
+    for (int d = 0; d < ndims && retval == NC_NOERR; d++)
+        retval = write_dimension(writer, ncid, dimids[d], &unlimited);
+    writer.end_array();
+    writer.key("variables");
+    writer.begin_array();
+    for (int v = 0; v < nvars && retval == NC_NOERR; v++)
+        retval = write_variable(writer, ncid, varids[v]);
+    writer.end_array();
+    if (retval == NC_NOERR)
+    {
+        writer.key("attributes");
+        retval = write_attributes(writer, ncid, NC_GLOBAL, natts);
+    }
+    writer.key("subgroups");
+    writer.begin_array();
+    for (int g = 0; g < ngroups && retval == NC_NOERR; g++)
+        retval = write_group(writer, groups[g]);
+    writer.end_array();
+    writer.end_object();
+    return retval;
+}
+
+} // namespace
+
+v8::MaybeLocal<v8::Value> Metadata::to_object(v8::Isolate *isolate, int ncid, int &retval)
+{
+    ObjectWriter writer(isolate);
+    retval = write_group(writer, ncid);
+    if (retval != NC_NOERR)
+        return {};
+    return writer.result();
+}
+
+int Metadata::to_json(int ncid, std::string &json)
+{
+    json.clear();
+    JsonWriter writer(json);
+    return write_group(writer, ncid);
+}
+
+} // namespace nodenetcdfjs
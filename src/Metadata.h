@@ -0,0 +1,46 @@
+#ifndef NODENETCDFJS_METADATA_H
+#define NODENETCDFJS_METADATA_H
+
+#include <netcdf.h>
+#include <node.h>
+#include <string>
+
+namespace nodenetcdfjs
+{
+
+/**
+ * @brief Snapshot of the metadata of a group tree, built without wrapper objects
+ *
+ * Walks groups, dimensions, variables and attributes with nc_inq_* calls only and emits
+ * the tree in one pass, either as plain JavaScript objects or as JSON text. The shape
+ * follows the toJSON() methods of the wrappers; variables additionally carry their
+ * storage settings (endianness, checksummode, chunkmode, chunksizes, fillmode, fillvalue,
+ * compressionshuffle, compressiondeflate, compressionlevel) and dimensions whether they
+ * are unlimited. 64-bit integers are emitted as decimal strings, as in Attribute.toJSON().
+ */
+class Metadata
+{
+  public:
+    Metadata() = delete;
+
+    /**
+     * @brief Describe a group and its descendants as plain objects
+     * @param isolate The V8 isolate
+     * @param ncid The group ID
+     * @param retval Set to the NetCDF error code on failure
+     * @return The description, or an empty handle on failure
+     */
+    [[nodiscard]] static v8::MaybeLocal<v8::Value> to_object(v8::Isolate *isolate, int ncid, int &retval);
+
+    /**
+     * @brief Describe a group and its descendants as JSON text
+     * @param ncid The group ID
+     * @param json Receives the JSON text
+     * @return NC_NOERR on success, the NetCDF error code otherwise
+     */
+    [[nodiscard]] static int to_json(int ncid, std::string &json);
+};
+
+} // namespace nodenetcdfjs
+
+#endif
@@ -0,0 +1,216 @@
+#include "UserType.h"
+#include "Variable.h"
+#include <cstring>
+#include <limits>
+#include <vector>
+
+namespace nodenetcdfjs
+{
+
+namespace
+{
+
+/**
+ * @brief Copy strided elements into a contiguous buffer
+ */
+void gather(const uint8_t *data, size_t count, size_t stride, size_t size, uint8_t *target) noexcept
+{
+    if (stride == size)
+    {
+        if (count > 0)
+            memcpy(target, data, count * size);
+        return;
+    }
+    for (size_t i = 0; i < count; i++)
+        memcpy(target + i * size, data + i * stride, size);
+}
+
+/**
+ * @brief Pack strings into { data, offsets }, the layout of Variable.readStrings()
+ */
+v8::MaybeLocal<v8::Value> decode_strings(v8::Isolate *isolate, const uint8_t *data, size_t count, size_t stride,
+                                         int &retval)
+{
+    const auto string_at = [data, stride](size_t i) {
+        const char *value;
+        memcpy(&value, data + i * stride, sizeof(value));
+        return value;
+    };
+    size_t length = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        if (const char *value = string_at(i))
+            length += strlen(value);
+    }
+    if (length > static_cast<size_t>(std::numeric_limits<int32_t>::max()))
+    {
+        retval = NC_ERANGE;
+        return {};
+    }
+    v8::Local<v8::ArrayBuffer> bytes = v8::ArrayBuffer::New(isolate, length);
+    v8::Local<v8::ArrayBuffer> offsets = v8::ArrayBuffer::New(isolate, (count + 1) * sizeof(int32_t));
+    auto *target = static_cast<char *>(bytes->GetBackingStore()->Data());
+    auto *offset = static_cast<int32_t *>(offsets->GetBackingStore()->Data());
+    size_t position = 0;
+    offset[0] = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        if (const char *value = string_at(i))
+        {
+            const size_t value_length = strlen(value);
+            memcpy(target + position, value, value_length);
+            position += value_length;
+        }
+        offset[i + 1] = static_cast<int32_t>(position);
+    }
+    v8::Local<v8::Context> context = isolate->GetCurrentContext();
+    v8::Local<v8::Object> result = v8::Object::New(isolate);
+    (void)result->CreateDataProperty(context, v8::String::NewFromUtf8Literal(isolate, "data"),
+                                     v8::Uint8Array::New(bytes, 0, length));
+    (void)result->CreateDataProperty(context, v8::String::NewFromUtf8Literal(isolate, "offsets"),
+                                     v8::Int32Array::New(offsets, 0, count + 1));
+    return result;
+}
+
+} // namespace
+
+int UserType::name(int ncid, nc_type type, std::string &name) noexcept
+{
+    char buffer[NC_MAX_NAME + 1] = {};
+    const int retval = nc_inq_type(ncid, type, buffer, nullptr);
+    if (retval == NC_NOERR)
+        name = buffer;
+    return retval;
+}
+
+v8::MaybeLocal<v8::Value> UserType::decode(v8::Isolate *isolate, int ncid, nc_type type, const uint8_t *data,
+                                           size_t count, size_t stride, int &retval)
+{
+    if (type == NC_STRING)
+        return decode_strings(isolate, data, count, stride, retval);
+
+    v8::Local<v8::Context> context = isolate->GetCurrentContext();
+    size_t size = 0;
+    nc_type base = NC_NAT;
+    size_t nfields = 0;
+    int type_class = NC_NAT;
+    retval = is_user_type(type) ? nc_inq_user_type(ncid, type, nullptr, &size, &base, &nfields, &type_class)
+                                : nc_inq_type(ncid, type, nullptr, &size);
+    if (retval != NC_NOERR)
+        return {};
+
+    if (!is_user_type(type) || type_class == NC_OPAQUE)
+    {
+        v8::Local<v8::ArrayBuffer> buffer = v8::ArrayBuffer::New(isolate, count * size);
+        gather(data, count, stride, size, static_cast<uint8_t *>(buffer->GetBackingStore()->Data()));
+        v8::Local<v8::Object> values = is_user_type(type)
+                                           ? v8::Local<v8::Object>(v8::Uint8Array::New(buffer, 0, count * size))
+                                           : Variable::make_typed_array(type, buffer, 0, count);
+        if (values.IsEmpty())
+            retval = NC_EBADTYPE;
+        return values;
+    }
+
+    switch (type_class)
+    {
+    case NC_ENUM:
+        // Enum values are stored as their base type
+        return decode(isolate, ncid, base, data, count, stride, retval);
+    case NC_VLEN: {
+        size_t base_size = 0;
+        retval = nc_inq_type(ncid, base, nullptr, &base_size);
+        if (retval != NC_NOERR)
+            return {};
+        size_t length = 0;
+        for (size_t i = 0; i < count; i++)
+        {
+            nc_vlen_t vlen;
+            memcpy(&vlen, data + i * stride, sizeof(vlen));
+            length += vlen.len;
+        }
+        if (length > static_cast<size_t>(std::numeric_limits<int32_t>::max()))
+        {
+            retval = NC_ERANGE;
+            return {};
+        }
+        // Concatenate the sequences, then decode them as one run of base values
+        std::vector<uint8_t> scratch(length * base_size);
+        v8::Local<v8::ArrayBuffer> offsets = v8::ArrayBuffer::New(isolate, (count + 1) * sizeof(int32_t));
+        auto *offset = static_cast<int32_t *>(offsets->GetBackingStore()->Data());
+        size_t position = 0;
+        offset[0] = 0;
+        for (size_t i = 0; i < count; i++)
+        {
+            nc_vlen_t vlen;
+            memcpy(&vlen, data + i * stride, sizeof(vlen));
+            if (vlen.len > 0)
+                memcpy(scratch.data() + position * base_size, vlen.p, vlen.len * base_size);
+            position += vlen.len;
+            offset[i + 1] = static_cast<int32_t>(position);
+        }
+        v8::Local<v8::Value> values;
+        if (!decode(isolate, ncid, base, scratch.data(), length, base_size, retval).ToLocal(&values))
+            return {};
+        v8::Local<v8::Object> result = v8::Object::New(isolate);
+        (void)result->CreateDataProperty(context, v8::String::NewFromUtf8Literal(isolate, "values"), values);
+        (void)result->CreateDataProperty(context, v8::String::NewFromUtf8Literal(isolate, "offsets"),
+                                         v8::Int32Array::New(offsets, 0, count + 1));
+        return result;
+    }
+    case NC_COMPOUND: {
+        v8::Local<v8::Object> result = v8::Object::New(isolate);
+        for (size_t field = 0; field < nfields; field++)
+        {
+            char field_name[NC_MAX_NAME + 1] = {};
+            size_t field_offset = 0;
+            nc_type field_type = NC_NAT;
+            int field_ndims = 0;
+            retval = nc_inq_compound_field(ncid, type, static_cast<int>(field), field_name, &field_offset,
+                                           &field_type, &field_ndims, nullptr);
+            if (retval != NC_NOERR)
+                return {};
+            std::vector<int> dim_sizes(field_ndims);
+            if (field_ndims > 0)
+            {
+                retval = nc_inq_compound_fielddim_sizes(ncid, type, static_cast<int>(field), dim_sizes.data());
+                if (retval != NC_NOERR)
+                    return {};
+            }
+            size_t field_length = 1;
+            for (int d : dim_sizes)
+                field_length *= static_cast<size_t>(d);
+
+            v8::Local<v8::Value> column;
+            if (field_length == 1)
+            {
+                if (!decode(isolate, ncid, field_type, data + field_offset, count, stride, retval).ToLocal(&column))
+                    return {};
+            }
+            else
+            {
+                // Array members are flattened, so gather them first
+                size_t field_size = 0;
+                retval = nc_inq_type(ncid, field_type, nullptr, &field_size);
+                if (retval != NC_NOERR)
+                    return {};
+                const size_t run = field_length * field_size;
+                std::vector<uint8_t> scratch(count * run);
+                for (size_t i = 0; i < count; i++)
+                    memcpy(scratch.data() + i * run, data + i * stride + field_offset, run);
+                if (!decode(isolate, ncid, field_type, scratch.data(), count * field_length, field_size, retval)
+                         .ToLocal(&column))
+                    return {};
+            }
+            (void)result->CreateDataProperty(
+                context, v8::String::NewFromUtf8(isolate, field_name, v8::NewStringType::kInternalized).ToLocalChecked(),
+                column);
+        }
+        return result;
+    }
+    default:
+        retval = NC_EBADTYPE;
+        return {};
+    }
+}
+
+} // namespace nodenetcdfjs
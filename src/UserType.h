@@ -0,0 +1,67 @@
+#ifndef NODENETCDFJS_USERTYPE_H
+#define NODENETCDFJS_USERTYPE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <netcdf.h>
+#include <node.h>
+#include <string>
+
+namespace nodenetcdfjs
+{
+
+/**
+ * @brief Columnar decoding of user-defined (compound, enum, VLEN, opaque) types
+ *
+ * Values read with nc_get_vara() into the library's in-memory layout are turned into
+ * struct-of-arrays results instead of one JavaScript object per element:
+ * - atomic types become one typed array (strings: { data, offsets } in Arrow's utf8 layout),
+ * - enums become a typed array of their base type,
+ * - opaques become a Uint8Array of count * size bytes,
+ * - VLENs become { values, offsets }, values i spanning offsets[i] to offsets[i + 1],
+ * - compounds become an object with one decoded column per member; array members are
+ *   flattened, count * member elements in C order.
+ *
+ * Decoding recurses, so members may themselves be compounds, VLENs or strings.
+ */
+class UserType
+{
+  public:
+    UserType() = delete;
+
+    /**
+     * @brief Whether a type is user-defined rather than atomic
+     */
+    [[nodiscard]] static constexpr bool is_user_type(nc_type type) noexcept
+    {
+        return type >= NC_FIRSTUSERTYPEID;
+    }
+
+    /**
+     * @brief Decode elements of a type into columns
+     * @param isolate The V8 isolate
+     * @param ncid Any group of the file defining the type
+     * @param type The type of the elements
+     * @param data First element, in the library's in-memory layout
+     * @param count Number of elements
+     * @param stride Distance in bytes between consecutive elements
+     * @param retval Set to the NetCDF error code on failure
+     * @return The decoded columns, or an empty handle on failure
+     */
+    [[nodiscard]] static v8::MaybeLocal<v8::Value> decode(v8::Isolate *isolate, int ncid, nc_type type,
+                                                          const uint8_t *data, size_t count, size_t stride,
+                                                          int &retval);
+
+    /**
+     * @brief Get the name of an atomic or user-defined type
+     * @param ncid Any group of the file defining the type
+     * @param type The type
+     * @param name Receives the name
+     * @return NC_NOERR on success, the NetCDF error code otherwise
+     */
+    [[nodiscard]] static int name(int ncid, nc_type type, std::string &name) noexcept;
+};
+
+} // namespace nodenetcdfjs
+
+#endif
@@ -1,16 +1,317 @@
 #include "Variable.h"
+#include "AsyncIO.h"
 #include "Attribute.h"
+#include "ChunkIterator.h"
 #include "Dimension.h"
+#include "MappedFile.h"
+#include "UserType.h"
+#include "WrapperCache.h"
 #include "nodenetcdfjs.h"
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
 
 namespace nodenetcdfjs
 {
 
+namespace
+{
+/**
+ * @brief State of one asynchronous slice read or write
+ *
+ * Shared by the work and the completion queued on AsyncIO; everything the I/O thread
+ * touches is plain data so that no V8 object is accessed off the JavaScript thread.
+ */
+struct SliceWork
+{
+    v8::Isolate *isolate{nullptr};
+    v8::Global<v8::Promise::Resolver> resolver;
+    v8::Global<v8::Object> holder;
+    std::shared_ptr<v8::BackingStore> store;
+    size_t byte_offset{0};
+    size_t length{0};
+    int parent_id{-1};
+    int id{-1};
+    nc_type type{NC_NAT};
+    bool write{false};
+    std::vector<size_t> pos;
+    std::vector<size_t> size;
+    std::vector<ptrdiff_t> stride;
+    int retval{NC_NOERR};
+};
+
+/**
+ * @brief Run the NetCDF call of an asynchronous slice operation, on the I/O thread
+ */
+void execute_slice(SliceWork &work)
+{
+    void *data = static_cast<uint8_t *>(work.store->Data()) + work.byte_offset;
+    const ptrdiff_t *stride = work.stride.empty() ? nullptr : work.stride.data();
+    if (work.write)
+        work.retval = nc_put_vars(work.parent_id, work.id, work.pos.data(), work.size.data(), stride, data);
+    else
+        work.retval = nc_get_vars(work.parent_id, work.id, work.pos.data(), work.size.data(), stride, data);
+}
+
+/**
+ * @brief Read a (strided) hyperslab converted to a memory type
+ * @param ncid The parent group/file ID
+ * @param varid The variable ID
+ * @param mem_type The NetCDF type of the elements in data
+ * @param start Starting index for each dimension
+ * @param count Number of elements for each dimension
+ * @param stride Stride for each dimension, or nullptr for a contiguous slice
+ * @param data Destination, large enough for the product of count elements of mem_type
+ * @return NC_NOERR on success, the NetCDF error code otherwise
+ *
+ * Uses the typed nc_get_vars_* entry points so the library converts while copying
+ * out of its buffers instead of a second pass over a native-typed copy.
+ */
+int get_vars_as(int ncid, int varid, nc_type mem_type, const size_t *start, const size_t *count,
+                const ptrdiff_t *stride, void *data)
+{
+    switch (mem_type)
+    {
+    case NC_BYTE:
+        return nc_get_vars_schar(ncid, varid, start, count, stride, static_cast<signed char *>(data));
+    case NC_CHAR:
+        return nc_get_vars_text(ncid, varid, start, count, stride, static_cast<char *>(data));
+    case NC_SHORT:
+        return nc_get_vars_short(ncid, varid, start, count, stride, static_cast<short *>(data));
+    case NC_INT:
+        return nc_get_vars_int(ncid, varid, start, count, stride, static_cast<int *>(data));
+    case NC_FLOAT:
+        return nc_get_vars_float(ncid, varid, start, count, stride, static_cast<float *>(data));
+    case NC_DOUBLE:
+        return nc_get_vars_double(ncid, varid, start, count, stride, static_cast<double *>(data));
+    case NC_UBYTE:
+        return nc_get_vars_uchar(ncid, varid, start, count, stride, static_cast<unsigned char *>(data));
+    case NC_USHORT:
+        return nc_get_vars_ushort(ncid, varid, start, count, stride, static_cast<unsigned short *>(data));
+    case NC_UINT:
+        return nc_get_vars_uint(ncid, varid, start, count, stride, static_cast<unsigned int *>(data));
+    case NC_INT64:
+        return nc_get_vars_longlong(ncid, varid, start, count, stride, static_cast<long long *>(data));
+    case NC_UINT64:
+        return nc_get_vars_ulonglong(ncid, varid, start, count, stride, static_cast<unsigned long long *>(data));
+    default:
+        return NC_EBADTYPE;
+    }
+}
+
+/**
+ * @brief Apply CF packing in place: value * scale_factor + add_offset
+ * @param data Values converted to T by the read
+ * @param length Number of values
+ * @param scale_factor The scale_factor attribute, 1 if absent
+ * @param add_offset The add_offset attribute, 0 if absent
+ *
+ * A branch-free loop over one type, which release builds auto-vectorize. The per-value
+ * kernels of this binding are all written this way rather than with SIMD intrinsics, so
+ * they stay portable across compilers and platforms; mask_values() and swap_copy() in
+ * MappedFile.cpp refer back here.
+ */
+template <typename T> void unpack_values(T *data, size_t length, double scale_factor, double add_offset) noexcept
+{
+    const T scale = static_cast<T>(scale_factor);
+    const T offset = static_cast<T>(add_offset);
+    for (size_t i = 0; i < length; i++)
+        data[i] = data[i] * scale + offset;
+}
+
+/**
+ * @brief Replace missing values with NaN in place
+ * @param data Values converted to T by the read
+ * @param length Number of values
+ * @param missing Missing values (_FillValue, missing_value) converted to T
+ *
+ * A compare-and-blend per missing value, vectorized like unpack_values().
+ */
+template <typename T> void mask_values(T *data, size_t length, const std::vector<T> &missing) noexcept
+{
+    const T nan = std::numeric_limits<T>::quiet_NaN();
+    for (const T m : missing)
+        for (size_t i = 0; i < length; i++)
+            data[i] = data[i] == m ? nan : data[i];
+}
+
+/**
+ * @brief Build a validity bitmap for values read as T
+ * @param data Values converted to T by the read
+ * @param length Number of values
+ * @param missing Missing values (_FillValue, missing_value), exact for 64-bit integer variables
+ * @param bits Zeroed bitmap of (length + 7) / 8 bytes; bit i (LSB first) is set when value i is valid
+ */
+template <typename T, typename Missing>
+void validity_bits(const T *data, size_t length, const std::vector<Missing> &missing, uint8_t *bits) noexcept
+{
+    std::vector<T> converted(missing.size());
+    for (size_t m = 0; m < missing.size(); m++)
+        converted[m] = static_cast<T>(missing[m]);
+    for (size_t i = 0; i < length; i++)
+    {
+        bool valid = true;
+        for (const T m : converted)
+            valid &= data[i] != m;
+        bits[i >> 3] |= static_cast<uint8_t>(valid) << (i & 7);
+    }
+}
+
+/**
+ * @brief Mask and unpack values read as a floating point type
+ * @param data Values converted to T by the read
+ * @param length Number of values
+ * @param missing Missing values as doubles, empty to skip masking
+ * @param unpack Whether to apply scale_factor and add_offset afterwards
+ * @param scale_factor The scale_factor attribute
+ * @param add_offset The add_offset attribute
+ *
+ * Missing values are compared in the packed domain, before unpacking.
+ */
+template <typename T>
+void mask_and_unpack(T *data, size_t length, const std::vector<double> &missing, bool unpack, double scale_factor,
+                     double add_offset) noexcept
+{
+    if (!missing.empty())
+    {
+        std::vector<T> converted(missing.size());
+        for (size_t m = 0; m < missing.size(); m++)
+            converted[m] = static_cast<T>(missing[m]);
+        mask_values(data, length, converted);
+    }
+    if (unpack && (scale_factor != 1.0 || add_offset != 0.0))
+        unpack_values(data, length, scale_factor, add_offset);
+}
+
+/// Running statistics of one output cell of Variable.reduce()
+struct Accumulator
+{
+    double min{std::numeric_limits<double>::infinity()};
+    double max{-std::numeric_limits<double>::infinity()};
+    double sum{0.0};
+    double count{0.0};
+};
+
+/**
+ * @brief Fold a contiguous run of values into accumulators, skipping NaN and missing values
+ * @param values The values, read as double
+ * @param length Number of values
+ * @param missing Missing values to skip
+ * @param acc First accumulator
+ * @param acc_step 0 to fold the whole run into acc, 1 to fold value i into acc[i]
+ * @param scale_factor Multiplier applied to valid values (1 unless unpacking)
+ * @param add_offset Offset applied to valid values (0 unless unpacking)
+ */
+void accumulate(const double *values, size_t length, const std::vector<double> &missing, Accumulator *acc,
+                size_t acc_step, double scale_factor, double add_offset) noexcept
+{
+    for (size_t i = 0; i < length; i++)
+    {
+        const double raw = values[i];
+        bool valid = raw == raw;
+        for (const double m : missing)
+            valid &= raw != m;
+        const double v = raw * scale_factor + add_offset;
+        Accumulator &a = acc[i * acc_step];
+        a.min = valid && v < a.min ? v : a.min;
+        a.max = valid && v > a.max ? v : a.max;
+        a.sum += valid ? v : 0.0;
+        a.count += valid ? 1.0 : 0.0;
+    }
+}
+
+/// Default fill value for each NetCDF data type, indexed by nc_type (NC_NAT .. NC_UINT)
+constexpr std::array<double, 10> default_fill_values = {
+    0, NC_FILL_BYTE, NC_FILL_CHAR, NC_FILL_SHORT, NC_FILL_INT, NC_FILL_FLOAT, NC_FILL_DOUBLE, NC_FILL_UBYTE,
+    NC_FILL_USHORT, NC_FILL_UINT};
+
+/**
+ * @brief Find the run of block-sorted points starting at first that fall in the same block
+ * @param coords Flat npoints x ndims indices
+ * @param order Point indices sorted by block
+ * @param block Block shape
+ * @param first Position in order where the run starts
+ * @param start Receives the lower corner of the bounding box of the run
+ * @param count Receives the extent of the bounding box of the run
+ * @return Position in order just past the run
+ */
+size_t next_block_run(const std::vector<size_t> &coords, const std::vector<size_t> &order,
+                      const std::vector<size_t> &block, size_t first, std::vector<size_t> &start,
+                      std::vector<size_t> &count)
+{
+    const size_t ndims = block.size();
+    const size_t *p = &coords[order[first] * ndims];
+    std::vector<size_t> end(ndims);
+    for (size_t d = 0; d < ndims; d++)
+    {
+        start[d] = p[d];
+        end[d] = p[d] + 1;
+    }
+    size_t last = first + 1;
+    for (; last < order.size(); last++)
+    {
+        const size_t *q = &coords[order[last] * ndims];
+        bool same = true;
+        for (size_t d = 0; d < ndims && same; d++)
+            same = p[d] / block[d] == q[d] / block[d];
+        if (!same)
+            break;
+        for (size_t d = 0; d < ndims; d++)
+        {
+            start[d] = std::min(start[d], q[d]);
+            end[d] = std::max(end[d], q[d] + 1);
+        }
+    }
+    for (size_t d = 0; d < ndims; d++)
+        count[d] = end[d] - start[d];
+    return last;
+}
+
+/**
+ * @brief Get the row-major offset of a point inside a box
+ * @param point The point's indices
+ * @param start Lower corner of the box
+ * @param count Extent of the box
+ * @return The element offset
+ */
+size_t box_offset(const size_t *point, const std::vector<size_t> &start, const std::vector<size_t> &count)
+{
+    size_t offset = 0;
+    for (size_t d = 0; d < count.size(); d++)
+        offset = offset * count[d] + (point[d] - start[d]);
+    return offset;
+}
+
+/**
+ * @brief Get the number of elements in a box
+ * @param count Extent of the box
+ * @return The product of the extents
+ */
+size_t box_size(const std::vector<size_t> &count)
+{
+    size_t size = 1;
+    for (const size_t c : count)
+        size *= c;
+    return size;
+}
+
+/// Default upper bound of a chunk cache sized from an access pattern
+constexpr size_t default_auto_cache_bytes = 256 << 20;
+
+/// Default block size limit of Variable.chunks() and highWaterMark of Variable.createReadStream()
+constexpr size_t default_block_bytes = 4 << 20;
+
+} // namespace
+
 // Static constexpr arrays are defined in the header file
-constexpr std::array<unsigned char, 11> Variable::type_sizes;
-constexpr std::array<const char *, 11> Variable::type_names;
+constexpr std::array<unsigned char, 12> Variable::type_sizes;
+constexpr std::array<const char *, 13> Variable::type_names;
 
 v8::Persistent<v8::Function> Variable::constructor;
+v8::Persistent<v8::Function> Variable::writable;
 
 Variable::Variable(int id_, int parent_id_) noexcept
     : id(id_)
@@ -20,31 +321,211 @@ Variable::Variable(int id_, int parent_id_) noexcept
     v8::Local<v8::Object> obj =
         v8::Local<v8::Function>::New(isolate, constructor)->NewInstance(isolate->GetCurrentContext()).ToLocalChecked();
     Wrap(obj);
-    const int retval = nc_inq_var(parent_id, id, nullptr, &type, &ndims, nullptr, nullptr);
+    const int retval = load_metadata();
     if (retval != NC_NOERR)
         throw_netcdf_error(isolate, retval);
 }
 
-void Variable::Init(v8::Local<v8::Object> exports)
+int Variable::load_metadata() noexcept
+{
+    char var_name[NC_MAX_NAME + 1];
+    int retval = nc_inq_var(parent_id, id, var_name, &type, &ndims, nullptr, nullptr);
+    if (retval != NC_NOERR)
+    {
+        ndims = 0;
+        return retval;
+    }
+    name = var_name;
+    // Size every per-dimension cache up front, so that an early return below leaves them consistent with ndims
+    dimids.assign(ndims, 0);
+    lengths.assign(ndims, 0);
+    unlimited.assign(ndims, false);
+    chunk_sizes.assign(ndims, 0);
+    retval = nc_inq_vardimid(parent_id, id, dimids.data());
+    if (retval != NC_NOERR)
+        return retval;
+
+    // Unlimited dimensions may be defined in any ancestor group
+    std::vector<int> unlimited_ids;
+    for (int grp = parent_id;;)
+    {
+        int nunlimited = 0;
+        retval = nc_inq_unlimdims(grp, &nunlimited, nullptr);
+        if (retval != NC_NOERR)
+            return retval;
+        const size_t offset = unlimited_ids.size();
+        unlimited_ids.resize(offset + nunlimited);
+        if (nunlimited > 0 && (retval = nc_inq_unlimdims(grp, nullptr, unlimited_ids.data() + offset)) != NC_NOERR)
+            return retval;
+        if (nc_inq_grp_parent(grp, &grp) != NC_NOERR)
+            break;
+    }
+
+    for (int i = 0; i < ndims; i++)
+    {
+        for (const int unlimited_id : unlimited_ids)
+            if (unlimited_id == dimids[i])
+                unlimited[i] = true;
+        retval = nc_inq_dimlen(parent_id, dimids[i], &lengths[i]);
+        if (retval != NC_NOERR)
+            return retval;
+    }
+    return load_chunking();
+}
+
+int Variable::load_chunking() noexcept
+{
+    chunk_sizes.assign(ndims, 0);
+    const int retval = nc_inq_var_chunking(parent_id, id, &storage, chunk_sizes.data());
+    if (retval == NC_ENOTNC4)
+    {
+        // Classic formats have no chunking; records behave like chunks of one along the record dimension
+        storage = NC_CONTIGUOUS;
+        return NC_NOERR;
+    }
+    return retval;
+}
+
+const std::vector<size_t> &Variable::current_lengths() noexcept
+{
+    for (int i = 0; i < ndims; i++)
+        if (unlimited[i])
+            (void)nc_inq_dimlen(parent_id, dimids[i], &lengths[i]);
+    return lengths;
+}
+
+int Variable::load_packing() noexcept
+{
+    scale_factor = 1.0;
+    add_offset = 0.0;
+    int retval = nc_get_att_double(parent_id, id, "scale_factor", &scale_factor);
+    if (retval != NC_NOERR && retval != NC_ENOTATT)
+        return retval;
+    retval = nc_get_att_double(parent_id, id, "add_offset", &add_offset);
+    if (retval != NC_NOERR && retval != NC_ENOTATT)
+        return retval;
+    packing_loaded = true;
+    return NC_NOERR;
+}
+
+void Variable::attributes_changed(v8::Isolate *isolate, int parent_id, int var_id)
+{
+    if (var_id == NC_GLOBAL)
+        return;
+    v8::Local<v8::Object> handle = WrapperCache::get(isolate, WrapperCache::Kind::Variable, parent_id, var_id);
+    if (handle.IsEmpty())
+        return;
+    auto *obj = node::ObjectWrap::Unwrap<Variable>(handle);
+    obj->packing_loaded = false;
+    obj->missing_loaded = false;
+}
+
+int Variable::load_missing_values() noexcept
+{
+    missing_values.clear();
+    missing_integers.clear();
+    double fill_value;
+    bool default_fill = false;
+    int retval = nc_get_att_double(parent_id, id, "_FillValue", &fill_value);
+    if (retval == NC_NOERR)
+        missing_values.push_back(fill_value);
+    else if (retval == NC_ENOTATT)
+    {
+        // Without a _FillValue attribute, unwritten values hold the type's default unless filling is off
+        int no_fill = 0;
+        retval = nc_inq_var_fill(parent_id, id, &no_fill, nullptr);
+        if (retval != NC_NOERR)
+            return retval;
+        default_fill = !no_fill;
+        if (default_fill && type >= NC_BYTE && type <= NC_UINT)
+            missing_values.push_back(default_fill_values[type]);
+    }
+    else
+        return retval;
+
+    if (type == NC_INT64 || type == NC_UINT64)
+    {
+        // Doubles cannot hold every 64-bit value, so the attributes are read again without conversion
+        for (const char *attribute : {"_FillValue", "missing_value"})
+        {
+            nc_type attribute_type = NC_NAT;
+            size_t len = 0;
+            retval = nc_inq_att(parent_id, id, attribute, &attribute_type, &len);
+            if (retval == NC_ENOTATT)
+                continue;
+            if (retval != NC_NOERR)
+                return retval;
+            std::vector<long long> values(len);
+            retval = attribute_type == type ? nc_get_att(parent_id, id, attribute, values.data())
+                                            : nc_get_att_longlong(parent_id, id, attribute, values.data());
+            // A textual missing_value cannot match numeric data
+            if (retval == NC_ECHAR)
+                continue;
+            if (retval != NC_NOERR && retval != NC_ERANGE)
+                return retval;
+            missing_integers.insert(missing_integers.end(), values.begin(), values.end());
+        }
+        if (default_fill)
+            missing_integers.push_back(type == NC_INT64 ? static_cast<int64_t>(NC_FILL_INT64)
+                                                        : static_cast<int64_t>(NC_FILL_UINT64));
+    }
+
+    size_t len = 0;
+    retval = nc_inq_attlen(parent_id, id, "missing_value", &len);
+    if (retval == NC_NOERR && len > 0)
+    {
+        std::vector<double> values(len);
+        retval = nc_get_att_double(parent_id, id, "missing_value", values.data());
+        // A textual missing_value cannot match numeric data
+        if (retval != NC_NOERR && retval != NC_ECHAR)
+            return retval;
+        if (retval == NC_NOERR)
+            for (const double v : values)
+                if (std::find(missing_values.begin(), missing_values.end(), v) == missing_values.end())
+                    missing_values.push_back(v);
+    }
+    else if (retval != NC_NOERR && retval != NC_ENOTATT)
+        return retval;
+    missing_loaded = true;
+    return NC_NOERR;
+}
+
+void Variable::Init(v8::Local<v8::Object> exports, v8::Local<v8::Value> module)
 {
     v8::Isolate *isolate = exports->GetIsolate();
 
     v8::Local<v8::FunctionTemplate> tpl = v8::FunctionTemplate::New(isolate);
     tpl->SetClassName(v8::String::NewFromUtf8(isolate, "Variable", v8::NewStringType::kNormal).ToLocalChecked());
     tpl->InstanceTemplate()->SetInternalFieldCount(1);
-    NODE_SET_PROTOTYPE_METHOD(tpl, "read", Variable::Read);
-    NODE_SET_PROTOTYPE_METHOD(tpl, "readSlice", Variable::ReadSlice);
-    NODE_SET_PROTOTYPE_METHOD(tpl, "readStridedSlice", Variable::ReadStridedSlice);
-    NODE_SET_PROTOTYPE_METHOD(tpl, "write", Variable::Write);
-    NODE_SET_PROTOTYPE_METHOD(tpl, "writeSlice", Variable::WriteSlice);
-    NODE_SET_PROTOTYPE_METHOD(tpl, "writeStridedSlice", Variable::WriteStridedSlice);
-    NODE_SET_PROTOTYPE_METHOD(tpl, "addAttribute", Variable::AddAttribute);
-    NODE_SET_PROTOTYPE_METHOD(tpl, "inspect", Variable::Inspect);
-    NODE_SET_PROTOTYPE_METHOD(tpl, "toJSON", Variable::ToJSON);
+    NODE_SET_PROTOTYPE_METHOD(tpl, "read", serialized<Variable::Read>);
+    NODE_SET_PROTOTYPE_METHOD(tpl, "readSlice", serialized<Variable::ReadSlice>);
+    NODE_SET_PROTOTYPE_METHOD(tpl, "readStridedSlice", serialized<Variable::ReadStridedSlice>);
+    NODE_SET_PROTOTYPE_METHOD(tpl, "readStrings", serialized<Variable::ReadStrings>);
+    NODE_SET_PROTOTYPE_METHOD(tpl, "write", serialized<Variable::Write>);
+    NODE_SET_PROTOTYPE_METHOD(tpl, "writeSlice", serialized<Variable::WriteSlice>);
+    NODE_SET_PROTOTYPE_METHOD(tpl, "writeStridedSlice", serialized<Variable::WriteStridedSlice>);
+    NODE_SET_PROTOTYPE_METHOD(tpl, "readSliceInto", serialized<Variable::ReadSliceInto>);
+    NODE_SET_PROTOTYPE_METHOD(tpl, "readStridedSliceInto", serialized<Variable::ReadStridedSliceInto>);
+    NODE_SET_PROTOTYPE_METHOD(tpl, "readPoints", serialized<Variable::ReadPoints>);
+    NODE_SET_PROTOTYPE_METHOD(tpl, "writePoints", serialized<Variable::WritePoints>);
+    NODE_SET_PROTOTYPE_METHOD(tpl, "appendRecords", serialized<Variable::AppendRecords>);
+    NODE_SET_PROTOTYPE_METHOD(tpl, "createAppendStream", serialized<Variable::CreateAppendStream>);
+    NODE_SET_PROTOTYPE_METHOD(tpl, "reduce", serialized<Variable::Reduce>);
+    NODE_SET_PROTOTYPE_METHOD(tpl, "chunks", serialized<Variable::Chunks>);
+    NODE_SET_PROTOTYPE_METHOD(tpl, "createReadStream", serialized<Variable::CreateReadStream>);
+    NODE_SET_PROTOTYPE_METHOD(tpl, "readSliceAsync", serialized<Variable::ReadSliceAsync>);
+    NODE_SET_PROTOTYPE_METHOD(tpl, "readStridedSliceAsync", serialized<Variable::ReadStridedSliceAsync>);
+    NODE_SET_PROTOTYPE_METHOD(tpl, "writeSliceAsync", serialized<Variable::WriteSliceAsync>);
+    NODE_SET_PROTOTYPE_METHOD(tpl, "writeStridedSliceAsync", serialized<Variable::WriteStridedSliceAsync>);
+    NODE_SET_PROTOTYPE_METHOD(tpl, "addAttribute", serialized<Variable::AddAttribute>);
+    NODE_SET_PROTOTYPE_METHOD(tpl, "inspect", serialized<Variable::Inspect>);
+    NODE_SET_PROTOTYPE_METHOD(tpl, "toJSON", serialized<Variable::ToJSON>);
     tpl->InstanceTemplate()->SetAccessor(
-        v8::String::NewFromUtf8(isolate, "id", v8::NewStringType::kNormal).ToLocalChecked(), Variable::GetId);
+        v8::String::NewFromUtf8(isolate, "id", v8::NewStringType::kNormal).ToLocalChecked(),
+        Variable::GetId);
     tpl->InstanceTemplate()->SetAccessor(
-        v8::String::NewFromUtf8(isolate, "type", v8::NewStringType::kNormal).ToLocalChecked(), Variable::GetType);
+        v8::String::NewFromUtf8(isolate, "type", v8::NewStringType::kNormal).ToLocalChecked(),
+        Variable::GetType);
     tpl->InstanceTemplate()->SetAccessor(
         v8::String::NewFromUtf8(isolate, "dimensions", v8::NewStringType::kNormal).ToLocalChecked(),
         Variable::GetDimensions);
@@ -52,49 +533,96 @@ void Variable::Init(v8::Local<v8::Object> exports)
         v8::String::NewFromUtf8(isolate, "attributes", v8::NewStringType::kNormal).ToLocalChecked(),
         Variable::GetAttributes);
     tpl->InstanceTemplate()->SetAccessor(
-        v8::String::NewFromUtf8(isolate, "name", v8::NewStringType::kNormal).ToLocalChecked(), Variable::GetName,
-        Variable::SetName);
+        v8::String::NewFromUtf8(isolate, "name", v8::NewStringType::kNormal).ToLocalChecked(),
+        Variable::GetName, serialized<Variable::SetName>);
     tpl->InstanceTemplate()->SetAccessor(
         v8::String::NewFromUtf8(isolate, "endianness", v8::NewStringType::kNormal).ToLocalChecked(),
-        Variable::GetEndianness, Variable::SetEndianness);
+        serialized<Variable::GetEndianness>, serialized<Variable::SetEndianness>);
     tpl->InstanceTemplate()->SetAccessor(
         v8::String::NewFromUtf8(isolate, "checksummode", v8::NewStringType::kNormal).ToLocalChecked(),
-        Variable::GetChecksumMode, Variable::SetChecksumMode);
+        serialized<Variable::GetChecksumMode>, serialized<Variable::SetChecksumMode>);
     tpl->InstanceTemplate()->SetAccessor(
         v8::String::NewFromUtf8(isolate, "chunkmode", v8::NewStringType::kNormal).ToLocalChecked(),
-        Variable::GetChunkMode, Variable::SetChunkMode);
+        serialized<Variable::GetChunkMode>, serialized<Variable::SetChunkMode>);
     tpl->InstanceTemplate()->SetAccessor(
         v8::String::NewFromUtf8(isolate, "chunksizes", v8::NewStringType::kNormal).ToLocalChecked(),
-        Variable::GetChunkSizes, Variable::SetChunkSizes);
+        serialized<Variable::GetChunkSizes>, serialized<Variable::SetChunkSizes>);
+    tpl->InstanceTemplate()->SetAccessor(
+        v8::String::NewFromUtf8(isolate, "chunkCache", v8::NewStringType::kNormal).ToLocalChecked(),
+        serialized<Variable::GetChunkCache>, serialized<Variable::SetChunkCache>);
     tpl->InstanceTemplate()->SetAccessor(
         v8::String::NewFromUtf8(isolate, "fillmode", v8::NewStringType::kNormal).ToLocalChecked(),
-        Variable::GetFillMode, Variable::SetFillMode);
+        serialized<Variable::GetFillMode>, serialized<Variable::SetFillMode>);
     tpl->InstanceTemplate()->SetAccessor(
         v8::String::NewFromUtf8(isolate, "fillvalue", v8::NewStringType::kNormal).ToLocalChecked(),
-        Variable::GetFillValue, Variable::SetFillValue);
+        serialized<Variable::GetFillValue>, serialized<Variable::SetFillValue>);
     tpl->InstanceTemplate()->SetAccessor(
         v8::String::NewFromUtf8(isolate, "compressionshuffle", v8::NewStringType::kNormal).ToLocalChecked(),
-        Variable::GetCompressionShuffle, Variable::SetCompressionShuffle);
+        serialized<Variable::GetCompressionShuffle>, serialized<Variable::SetCompressionShuffle>);
     tpl->InstanceTemplate()->SetAccessor(
         v8::String::NewFromUtf8(isolate, "compressiondeflate", v8::NewStringType::kNormal).ToLocalChecked(),
-        Variable::GetCompressionDeflate, Variable::SetCompressionDeflate);
+        serialized<Variable::GetCompressionDeflate>, serialized<Variable::SetCompressionDeflate>);
     tpl->InstanceTemplate()->SetAccessor(
         v8::String::NewFromUtf8(isolate, "compressionlevel", v8::NewStringType::kNormal).ToLocalChecked(),
-        Variable::GetCompressionLevel, Variable::SetCompressionLevel);
+        serialized<Variable::GetCompressionLevel>, serialized<Variable::SetCompressionLevel>);
     constructor.Reset(isolate, tpl->GetFunction(isolate->GetCurrentContext()).ToLocalChecked());
+
+    v8::Local<v8::Function> writable_class;
+    if (stream_class(isolate, module, "Writable").ToLocal(&writable_class))
+        writable.Reset(isolate, writable_class);
 }
 
 bool Variable::get_name(char *name) const noexcept
 {
-    const int retval = nc_inq_varname(parent_id, id, name);
-    if (retval != NC_NOERR)
-    {
-        throw_netcdf_error(v8::Isolate::GetCurrent(), retval);
-        return false;
-    }
+    snprintf(name, NC_MAX_NAME + 1, "%s", this->name.c_str());
     return true;
 }
 
+Variable *Variable::unwrap(v8::Isolate *isolate, v8::Local<v8::Value> value)
+{
+    if (!value->IsObject())
+        return nullptr;
+    v8::Local<v8::Object> object = value.As<v8::Object>();
+    // Objects merely inheriting from Variable.prototype have no internal field to unwrap
+    if (object->InternalFieldCount() < 1 ||
+        !object->InstanceOf(isolate->GetCurrentContext(), v8::Local<v8::Function>::New(isolate, constructor))
+             .FromMaybe(false))
+        return nullptr;
+    return node::ObjectWrap::Unwrap<Variable>(object);
+}
+
+int Variable::get_id() const noexcept
+{
+    return id;
+}
+
+int Variable::get_parent_id() const noexcept
+{
+    return parent_id;
+}
+
+nc_type Variable::get_element_type() const noexcept
+{
+    return type;
+}
+
+int Variable::get_ndims() const noexcept
+{
+    return ndims;
+}
+
+size_t Variable::element_size() const noexcept
+{
+    return (type < NC_BYTE || type > NC_UINT64) ? 0 : type_sizes[type];
+}
+
+int Variable::read_slice(const size_t *start, const size_t *count, const ptrdiff_t *stride, void *data) const noexcept
+{
+    if (stride != nullptr)
+        return nc_get_vars(parent_id, id, start, count, stride, data);
+    return nc_get_vara(parent_id, id, start, count, data);
+}
+
 void Variable::Write(const v8::FunctionCallbackInfo<v8::Value> &args)
 {
     v8::Isolate *isolate = args.GetIsolate();
@@ -102,8 +630,7 @@ void Variable::Write(const v8::FunctionCallbackInfo<v8::Value> &args)
 
     if (args.Length() != obj->ndims + 1)
     {
-        char name[NC_MAX_NAME + 1];
-        obj->get_name(name);
+        const char *name = obj->name.c_str();
         char error_msg[512];
         snprintf(error_msg, sizeof(error_msg), 
                 "Variable.write() for '%s': Wrong number of arguments. Expected %d (position arguments) + 1 (value) = %d, but got %d",
@@ -165,9 +692,18 @@ void Variable::Write(const v8::FunctionCallbackInfo<v8::Value> &args)
         retval = nc_put_vara(obj->parent_id, obj->id, pos.data(), size.data(), &v);
     }
     break;
+    case NC_INT64: {
+        const int64_t v = get_integer64<int64_t>(isolate, args[obj->ndims]);
+        retval = nc_put_vara(obj->parent_id, obj->id, pos.data(), size.data(), &v);
+    }
+    break;
+    case NC_UINT64: {
+        const uint64_t v = get_integer64<uint64_t>(isolate, args[obj->ndims]);
+        retval = nc_put_vara(obj->parent_id, obj->id, pos.data(), size.data(), &v);
+    }
+    break;
     default:
-        char name[NC_MAX_NAME + 1];
-        obj->get_name(name);
+        const char *name = obj->name.c_str();
         char error_msg[256];
         snprintf(error_msg, sizeof(error_msg),
                 "Variable.write() for '%s': Variable type %d not supported for write operations",
@@ -186,8 +722,7 @@ void Variable::WriteSlice(const v8::FunctionCallbackInfo<v8::Value> &args)
 {
     v8::Isolate *isolate = args.GetIsolate();
     Variable *obj = node::ObjectWrap::Unwrap<Variable>(args.Holder());
-    char name[NC_MAX_NAME + 1];
-    obj->get_name(name);
+    const char *name = obj->name.c_str();
     
     if (args.Length() != 2 * obj->ndims + 1)
     {
@@ -234,48 +769,14 @@ void Variable::WriteSlice(const v8::FunctionCallbackInfo<v8::Value> &args)
         return;
     }
 
-    bool correct_type;
     const char *expected_type_name = nullptr;
-    switch (obj->type)
+    const bool correct_type = is_matching_array(obj->type, val, expected_type_name);
+    if (expected_type_name == nullptr)
     {
-    case NC_BYTE:
-    case NC_CHAR:
-        correct_type = val->IsInt8Array();
-        expected_type_name = "Int8Array";
-        break;
-    case NC_SHORT:
-        correct_type = val->IsInt16Array();
-        expected_type_name = "Int16Array";
-        break;
-    case NC_INT:
-        correct_type = val->IsInt32Array();
-        expected_type_name = "Int32Array";
-        break;
-    case NC_FLOAT:
-        correct_type = val->IsFloat32Array();
-        expected_type_name = "Float32Array";
-        break;
-    case NC_DOUBLE:
-        correct_type = val->IsFloat64Array();
-        expected_type_name = "Float64Array";
-        break;
-    case NC_UBYTE:
-        correct_type = val->IsUint8Array();
-        expected_type_name = "Uint8Array";
-        break;
-    case NC_USHORT:
-        correct_type = val->IsUint16Array();
-        expected_type_name = "Uint16Array";
-        break;
-    case NC_UINT:
-        correct_type = val->IsUint32Array();
-        expected_type_name = "Uint32Array";
-        break;
-    default:
         char error_msg[256];
         snprintf(error_msg, sizeof(error_msg),
                 "Variable.writeSlice() for '%s': Variable type %d (%s) not supported for write operations",
-                name, obj->type, type_names[obj->type]);
+                name, obj->type, obj->type_name().c_str());
         isolate->ThrowException(v8::Exception::TypeError(
             v8::String::NewFromUtf8(isolate, error_msg, v8::NewStringType::kNormal)
                 .ToLocalChecked()));
@@ -296,7 +797,8 @@ void Variable::WriteSlice(const v8::FunctionCallbackInfo<v8::Value> &args)
         delete[] size;
         return;
     }
-    int retval = nc_put_vara(obj->parent_id, obj->id, pos, size, val->Buffer()->GetBackingStore()->Data());
+    int retval = nc_put_vara(obj->parent_id, obj->id, pos, size,
+                             static_cast<uint8_t *>(val->Buffer()->GetBackingStore()->Data()) + val->ByteOffset());
     if (retval != NC_NOERR)
     {
         throw_netcdf_error(isolate, retval);
@@ -309,8 +811,7 @@ void Variable::WriteStridedSlice(const v8::FunctionCallbackInfo<v8::Value> &args
 {
     v8::Isolate *isolate = args.GetIsolate();
     Variable *obj = node::ObjectWrap::Unwrap<Variable>(args.Holder());
-    char name[NC_MAX_NAME + 1];
-    obj->get_name(name);
+    const char *name = obj->name.c_str();
     
     if (args.Length() != 3 * obj->ndims + 1)
     {
@@ -360,48 +861,14 @@ void Variable::WriteStridedSlice(const v8::FunctionCallbackInfo<v8::Value> &args
         return;
     }
 
-    bool correct_type;
     const char *expected_type_name = nullptr;
-    switch (obj->type)
+    const bool correct_type = is_matching_array(obj->type, val, expected_type_name);
+    if (expected_type_name == nullptr)
     {
-    case NC_BYTE:
-    case NC_CHAR:
-        correct_type = val->IsInt8Array();
-        expected_type_name = "Int8Array";
-        break;
-    case NC_SHORT:
-        correct_type = val->IsInt16Array();
-        expected_type_name = "Int16Array";
-        break;
-    case NC_INT:
-        correct_type = val->IsInt32Array();
-        expected_type_name = "Int32Array";
-        break;
-    case NC_FLOAT:
-        correct_type = val->IsFloat32Array();
-        expected_type_name = "Float32Array";
-        break;
-    case NC_DOUBLE:
-        correct_type = val->IsFloat64Array();
-        expected_type_name = "Float64Array";
-        break;
-    case NC_UBYTE:
-        correct_type = val->IsUint8Array();
-        expected_type_name = "Uint8Array";
-        break;
-    case NC_USHORT:
-        correct_type = val->IsUint16Array();
-        expected_type_name = "Uint16Array";
-        break;
-    case NC_UINT:
-        correct_type = val->IsUint32Array();
-        expected_type_name = "Uint32Array";
-        break;
-    default:
         char error_msg[256];
         snprintf(error_msg, sizeof(error_msg),
                 "Variable.writeStridedSlice() for '%s': Variable type %d (%s) not supported for write operations",
-                name, obj->type, type_names[obj->type]);
+                name, obj->type, obj->type_name().c_str());
         isolate->ThrowException(v8::Exception::TypeError(
             v8::String::NewFromUtf8(isolate, error_msg, v8::NewStringType::kNormal)
                 .ToLocalChecked()));
@@ -424,7 +891,8 @@ void Variable::WriteStridedSlice(const v8::FunctionCallbackInfo<v8::Value> &args
         delete[] stride;
         return;
     }
-    int retval = nc_put_vars(obj->parent_id, obj->id, pos, size, stride, val->Buffer()->GetBackingStore()->Data());
+    int retval = nc_put_vars(obj->parent_id, obj->id, pos, size, stride,
+                             static_cast<uint8_t *>(val->Buffer()->GetBackingStore()->Data()) + val->ByteOffset());
     if (retval != NC_NOERR)
         throw_netcdf_error(isolate, retval);
     delete[] pos;
@@ -436,8 +904,7 @@ void Variable::Read(const v8::FunctionCallbackInfo<v8::Value> &args)
 {
     v8::Isolate *isolate = args.GetIsolate();
     Variable *obj = node::ObjectWrap::Unwrap<Variable>(args.Holder());
-    char name[NC_MAX_NAME + 1];
-    obj->get_name(name);
+    const char *name = obj->name.c_str();
     
     if (args.Length() != obj->ndims)
     {
@@ -450,7 +917,7 @@ void Variable::Read(const v8::FunctionCallbackInfo<v8::Value> &args)
                 .ToLocalChecked()));
         return;
     }
-    if (obj->type < NC_BYTE || obj->type > NC_UINT)
+    if (obj->type < NC_BYTE || obj->type > NC_UINT64)
     {
         char error_msg[256];
         snprintf(error_msg, sizeof(error_msg),
@@ -527,6 +994,18 @@ void Variable::Read(const v8::FunctionCallbackInfo<v8::Value> &args)
         result = v8::Integer::New(isolate, v);
     }
     break;
+    case NC_INT64: {
+        int64_t v;
+        retval = nc_get_vara(obj->parent_id, obj->id, pos, size, &v);
+        result = v8::BigInt::New(isolate, v);
+    }
+    break;
+    case NC_UINT64: {
+        uint64_t v;
+        retval = nc_get_vara(obj->parent_id, obj->id, pos, size, &v);
+        result = v8::BigInt::NewFromUnsigned(isolate, v);
+    }
+    break;
     }
     if (retval != NC_NOERR)
         throw_netcdf_error(isolate, retval);
@@ -536,195 +1015,1803 @@ void Variable::Read(const v8::FunctionCallbackInfo<v8::Value> &args)
     delete[] size;
 }
 
-void Variable::ReadSlice(const v8::FunctionCallbackInfo<v8::Value> &args)
+void Variable::ReadSlice(const v8::FunctionCallbackInfo<v8::Value> &args)
+{
+    v8::Isolate *isolate = args.GetIsolate();
+    Variable *obj = node::ObjectWrap::Unwrap<Variable>(args.Holder());
+    const char *name = obj->name.c_str();
+    
+    if (args.Length() != 2 * obj->ndims && args.Length() != 2 * obj->ndims + 1)
+    {
+        char error_msg[512];
+        snprintf(error_msg, sizeof(error_msg),
+                "Variable.readSlice() for '%s': Wrong number of arguments. Expected %d pairs (pos,size) [+ options] = %d arguments, but got %d",
+                name, obj->ndims, 2 * obj->ndims, args.Length());
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8(isolate, error_msg, v8::NewStringType::kNormal)
+                .ToLocalChecked()));
+        return;
+    }
+    if ((obj->type < NC_BYTE || obj->type > NC_UINT64) && !UserType::is_user_type(obj->type))
+    {
+        char error_msg[256];
+        snprintf(error_msg, sizeof(error_msg),
+                "Variable.readSlice() for '%s': Variable type %d not supported for read operations",
+                name, obj->type);
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8(isolate, error_msg, v8::NewStringType::kNormal)
+                .ToLocalChecked()));
+        return;
+    }
+    if (UserType::is_user_type(obj->type))
+    {
+        if (args.Length() == 2 * obj->ndims + 1 && !args[2 * obj->ndims]->IsUndefined())
+        {
+            char error_msg[256];
+            snprintf(error_msg, sizeof(error_msg),
+                    "Variable.readSlice() for '%s': Read options are not supported for user-defined type %s",
+                    name, obj->type_name().c_str());
+            isolate->ThrowException(v8::Exception::TypeError(
+                v8::String::NewFromUtf8(isolate, error_msg, v8::NewStringType::kNormal)
+                    .ToLocalChecked()));
+            return;
+        }
+        std::vector<size_t> pos(obj->ndims);
+        std::vector<size_t> size(obj->ndims);
+        size_t total_size = 1;
+        for (int i = 0; i < obj->ndims; i++)
+        {
+            pos[i] = static_cast<size_t>(args[2 * i]->IntegerValue(isolate->GetCurrentContext()).ToChecked());
+            size[i] = static_cast<size_t>(args[2 * i + 1]->IntegerValue(isolate->GetCurrentContext()).ToChecked());
+            total_size *= size[i];
+        }
+        v8::Local<v8::Value> result;
+        if (obj->read_user_type(isolate, pos.data(), size.data(), total_size).ToLocal(&result))
+            args.GetReturnValue().Set(result);
+        return;
+    }
+    ReadOptions options;
+    if (!obj->get_read_options(isolate, args[2 * obj->ndims], "readSlice", options))
+        return;
+
+    size_t *pos = new size_t[obj->ndims];
+    size_t *size = new size_t[obj->ndims];
+    size_t total_size = 1;
+    for (int i = 0; i < obj->ndims; i++)
+    {
+        pos[i] = static_cast<size_t>(args[2 * i]->IntegerValue(isolate->GetCurrentContext()).ToChecked());
+        size_t s = static_cast<size_t>(args[2 * i + 1]->IntegerValue(isolate->GetCurrentContext()).ToChecked());
+        size[i] = s;
+        total_size *= s;
+    }
+    // Contiguous slices of memory-mapped files skip the library and, when possible, the copy
+    std::shared_ptr<v8::BackingStore> mapped;
+    if (options.output_type == obj->type)
+    {
+        if (std::shared_ptr<MappedFile> file = MappedFile::find(obj->parent_id))
+            mapped = file->view(obj->id, pos, size);
+    }
+    const bool from_mapping = mapped != nullptr;
+    v8::Local<v8::ArrayBuffer> buffer =
+        from_mapping ? v8::ArrayBuffer::New(isolate, std::move(mapped))
+                     : v8::ArrayBuffer::New(isolate, total_size * type_sizes[options.output_type]);
+    int retval = NC_NOERR;
+    if (!from_mapping && options.output_type == obj->type)
+        retval = nc_get_vara(obj->parent_id, obj->id, pos, size, buffer->GetBackingStore()->Data());
+    else if (!from_mapping)
+        retval = get_vars_as(obj->parent_id, obj->id, options.output_type, pos, size, nullptr,
+                             buffer->GetBackingStore()->Data());
+    if (retval != NC_NOERR)
+    {
+        throw_netcdf_error(isolate, retval);
+        delete[] pos;
+        delete[] size;
+        return;
+    }
+    v8::Local<v8::Object> result = obj->make_read_result(isolate, options, buffer, total_size);
+    if (result.IsEmpty())
+    {
+        char error_msg[256];
+        snprintf(error_msg, sizeof(error_msg),
+                "Variable.readSlice() for '%s': Variable type %d (%s) not supported for creating typed array result",
+                name, obj->type, type_names[obj->type]);
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8(isolate, error_msg, v8::NewStringType::kNormal)
+                .ToLocalChecked()));
+        delete[] pos;
+        delete[] size;
+        return;
+    }
+    args.GetReturnValue().Set(result);
+    delete[] pos;
+    delete[] size;
+}
+
+v8::MaybeLocal<v8::Value> Variable::read_user_type(v8::Isolate *isolate, const size_t *pos, const size_t *size,
+                                                  size_t total_size)
+{
+    size_t type_size = 0;
+    int retval = nc_inq_type(parent_id, type, nullptr, &type_size);
+    v8::MaybeLocal<v8::Value> result;
+    if (retval == NC_NOERR)
+    {
+        std::vector<uint8_t> raw(total_size * type_size);
+        retval = nc_get_vara(parent_id, id, pos, size, raw.data());
+        if (retval == NC_NOERR)
+        {
+            result = UserType::decode(isolate, parent_id, type, raw.data(), total_size, type_size, retval);
+            // Free the strings and sequences the library allocated inside the elements
+            const int reclaimed = nc_reclaim_data(parent_id, type, raw.data(), total_size);
+            if (retval == NC_NOERR)
+                retval = reclaimed;
+        }
+    }
+    if (retval != NC_NOERR)
+    {
+        throw_netcdf_error(isolate, retval);
+        return {};
+    }
+    return result;
+}
+
+std::string Variable::type_name() const
+{
+    if (type >= NC_NAT && type <= NC_STRING)
+        return type_names[type];
+    std::string name;
+    if (UserType::name(parent_id, type, name) != NC_NOERR)
+        return "unknown";
+    return name;
+}
+
+void Variable::ReadStridedSlice(const v8::FunctionCallbackInfo<v8::Value> &args)
+{
+    v8::Isolate *isolate = args.GetIsolate();
+    Variable *obj = node::ObjectWrap::Unwrap<Variable>(args.Holder());
+    const char *name = obj->name.c_str();
+    
+    if (args.Length() != 3 * obj->ndims && args.Length() != 3 * obj->ndims + 1)
+    {
+        char error_msg[512];
+        snprintf(error_msg, sizeof(error_msg),
+                "Variable.readStridedSlice() for '%s': Wrong number of arguments. Expected %d triplets (pos,size,stride) [+ options] = %d arguments, but got %d",
+                name, obj->ndims, 3 * obj->ndims, args.Length());
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8(isolate, error_msg, v8::NewStringType::kNormal)
+                .ToLocalChecked()));
+        return;
+    }
+    if (obj->type < NC_BYTE || obj->type > NC_UINT64)
+    {
+        char error_msg[256];
+        snprintf(error_msg, sizeof(error_msg),
+                "Variable.readStridedSlice() for '%s': Variable type %d not supported for read operations",
+                name, obj->type);
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8(isolate, error_msg, v8::NewStringType::kNormal)
+                .ToLocalChecked()));
+        return;
+    }
+    ReadOptions options;
+    if (!obj->get_read_options(isolate, args[3 * obj->ndims], "readStridedSlice", options))
+        return;
+
+    size_t *pos = new size_t[obj->ndims];
+    size_t *size = new size_t[obj->ndims];
+    ptrdiff_t *stride = new ptrdiff_t[obj->ndims];
+    size_t total_size = 1;
+    for (int i = 0; i < obj->ndims; i++)
+    {
+        pos[i] = static_cast<size_t>(args[3 * i]->IntegerValue(isolate->GetCurrentContext()).ToChecked());
+        size_t s = static_cast<size_t>(args[3 * i + 1]->IntegerValue(isolate->GetCurrentContext()).ToChecked());
+        size[i] = s;
+        total_size *= s;
+        stride[i] = static_cast<ptrdiff_t>(args[3 * i + 2]->IntegerValue(isolate->GetCurrentContext()).ToChecked());
+    }
+    v8::Local<v8::ArrayBuffer> buffer = v8::ArrayBuffer::New(isolate, total_size * type_sizes[options.output_type]);
+    int retval = options.output_type == obj->type
+                     ? nc_get_vars(obj->parent_id, obj->id, pos, size, stride, buffer->GetBackingStore()->Data())
+                     : get_vars_as(obj->parent_id, obj->id, options.output_type, pos, size, stride,
+                                   buffer->GetBackingStore()->Data());
+    if (retval != NC_NOERR)
+    {
+        throw_netcdf_error(isolate, retval);
+        delete[] pos;
+        delete[] size;
+        delete[] stride;
+        return;
+    }
+    v8::Local<v8::Object> result = obj->make_read_result(isolate, options, buffer, total_size);
+    args.GetReturnValue().Set(result);
+    delete[] pos;
+    delete[] size;
+    delete[] stride;
+}
+
+v8::Local<v8::Object> Variable::make_typed_array(nc_type type, v8::Local<v8::ArrayBuffer> buffer, size_t byte_offset,
+                                                size_t length)
+{
+    switch (type)
+    {
+    case NC_BYTE:
+    case NC_CHAR:
+        return v8::Int8Array::New(buffer, byte_offset, length);
+    case NC_SHORT:
+        return v8::Int16Array::New(buffer, byte_offset, length);
+    case NC_INT:
+        return v8::Int32Array::New(buffer, byte_offset, length);
+    case NC_FLOAT:
+        return v8::Float32Array::New(buffer, byte_offset, length);
+    case NC_DOUBLE:
+        return v8::Float64Array::New(buffer, byte_offset, length);
+    case NC_UBYTE:
+        return v8::Uint8Array::New(buffer, byte_offset, length);
+    case NC_USHORT:
+        return v8::Uint16Array::New(buffer, byte_offset, length);
+    case NC_UINT:
+        return v8::Uint32Array::New(buffer, byte_offset, length);
+    case NC_INT64:
+        return v8::BigInt64Array::New(buffer, byte_offset, length);
+    case NC_UINT64:
+        return v8::BigUint64Array::New(buffer, byte_offset, length);
+    default:
+        return {};
+    }
+}
+
+bool Variable::is_matching_array(nc_type type, v8::Local<v8::TypedArray> array, const char *&expected_type_name)
+{
+    switch (type)
+    {
+    case NC_BYTE:
+    case NC_CHAR:
+        expected_type_name = "Int8Array";
+        return array->IsInt8Array();
+    case NC_SHORT:
+        expected_type_name = "Int16Array";
+        return array->IsInt16Array();
+    case NC_INT:
+        expected_type_name = "Int32Array";
+        return array->IsInt32Array();
+    case NC_FLOAT:
+        expected_type_name = "Float32Array";
+        return array->IsFloat32Array();
+    case NC_DOUBLE:
+        expected_type_name = "Float64Array";
+        return array->IsFloat64Array();
+    case NC_UBYTE:
+        expected_type_name = "Uint8Array";
+        return array->IsUint8Array();
+    case NC_USHORT:
+        expected_type_name = "Uint16Array";
+        return array->IsUint16Array();
+    case NC_UINT:
+        expected_type_name = "Uint32Array";
+        return array->IsUint32Array();
+    case NC_INT64:
+        expected_type_name = "BigInt64Array";
+        return array->IsBigInt64Array();
+    case NC_UINT64:
+        expected_type_name = "BigUint64Array";
+        return array->IsBigUint64Array();
+    default:
+        expected_type_name = nullptr;
+        return false;
+    }
+}
+
+bool Variable::get_read_options(v8::Isolate *isolate, v8::Local<v8::Value> value, const char *method,
+                                ReadOptions &options)
+{
+    v8::Local<v8::Context> context = isolate->GetCurrentContext();
+    options = ReadOptions{type, false, Mask::None};
+    if (value->IsUndefined())
+        return true;
+    char error_msg[512];
+    if (!value->IsObject())
+    {
+        snprintf(error_msg, sizeof(error_msg), "Variable.%s() for '%s': Options must be an object, but got %s",
+                 method, name.c_str(), *v8::String::Utf8Value(isolate, value->TypeOf(isolate)));
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8(isolate, error_msg, v8::NewStringType::kNormal).ToLocalChecked()));
+        return false;
+    }
+    v8::Local<v8::Object> object = value.As<v8::Object>();
+    options.unpack =
+        object->Get(context, v8::String::NewFromUtf8Literal(isolate, "unpack")).ToLocalChecked()->BooleanValue(isolate);
+    if (options.unpack)
+    {
+        // Unpacked values are fractional; doubles and 64-bit integers unpack to double, everything else to float
+        options.output_type = (type == NC_DOUBLE || type == NC_INT64 || type == NC_UINT64) ? NC_DOUBLE : NC_FLOAT;
+        if (!packing_loaded)
+        {
+            const int retval = load_packing();
+            if (retval != NC_NOERR)
+            {
+                throw_netcdf_error(isolate, retval);
+                return false;
+            }
+        }
+    }
+
+    v8::Local<v8::Value> mask = object->Get(context, v8::String::NewFromUtf8Literal(isolate, "mask")).ToLocalChecked();
+    if (mask->IsString() && std::string(*v8::String::Utf8Value(isolate, mask)) == "bitmap")
+        options.mask = Mask::Bitmap;
+    else if (mask->IsString() || (!mask->IsUndefined() && !mask->IsBoolean()))
+    {
+        snprintf(error_msg, sizeof(error_msg), "Variable.%s() for '%s': mask must be true, false or 'bitmap'", method,
+                 name.c_str());
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8(isolate, error_msg, v8::NewStringType::kNormal).ToLocalChecked()));
+        return false;
+    }
+    else if (mask->BooleanValue(isolate))
+        options.mask = Mask::NaN;
+    if (options.mask != Mask::None && !missing_loaded)
+    {
+        const int retval = load_missing_values();
+        if (retval != NC_NOERR)
+        {
+            throw_netcdf_error(isolate, retval);
+            return false;
+        }
+    }
+
+    v8::Local<v8::Value> output_type =
+        object->Get(context, v8::String::NewFromUtf8Literal(isolate, "outputType")).ToLocalChecked();
+    if (!output_type->IsUndefined())
+    {
+        const std::string type_str = *v8::String::Utf8Value(isolate, output_type);
+        const int requested = get_type(type_str);
+        if (requested < NC_BYTE || requested > NC_UINT64)
+        {
+            snprintf(error_msg, sizeof(error_msg),
+                     "Variable.%s() for '%s': Unknown outputType '%s'. Valid types are: byte, char, short, int, float, "
+                     "double, ubyte, ushort, uint, int64, uint64",
+                     method, name.c_str(), type_str.c_str());
+            isolate->ThrowException(v8::Exception::TypeError(
+                v8::String::NewFromUtf8(isolate, error_msg, v8::NewStringType::kNormal).ToLocalChecked()));
+            return false;
+        }
+        if (options.unpack && requested != NC_FLOAT && requested != NC_DOUBLE)
+        {
+            snprintf(error_msg, sizeof(error_msg),
+                     "Variable.%s() for '%s': outputType must be float or double when unpacking, but got '%s'", method,
+                     name.c_str(), type_str.c_str());
+            isolate->ThrowException(v8::Exception::TypeError(
+                v8::String::NewFromUtf8(isolate, error_msg, v8::NewStringType::kNormal).ToLocalChecked()));
+            return false;
+        }
+        options.output_type = requested;
+    }
+    if (options.mask == Mask::NaN && options.output_type != NC_FLOAT && options.output_type != NC_DOUBLE)
+    {
+        snprintf(error_msg, sizeof(error_msg),
+                 "Variable.%s() for '%s': Cannot mask %s values with NaN; use outputType 'float' or mask 'bitmap'",
+                 method, name.c_str(), type_names[options.output_type]);
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8(isolate, error_msg, v8::NewStringType::kNormal).ToLocalChecked()));
+        return false;
+    }
+    return true;
+}
+
+v8::Local<v8::Object> Variable::make_read_result(v8::Isolate *isolate, const ReadOptions &options,
+                                                v8::Local<v8::ArrayBuffer> buffer, size_t length) const
+{
+    void *data = buffer->Data();
+    v8::Local<v8::ArrayBuffer> validity;
+    if (options.mask == Mask::Bitmap)
+    {
+        validity = v8::ArrayBuffer::New(isolate, (length + 7) / 8);
+        auto *bits = static_cast<uint8_t *>(validity->Data());
+        memset(bits, 0, validity->ByteLength());
+        switch (options.output_type)
+        {
+        case NC_BYTE:
+        case NC_CHAR:
+            validity_bits(static_cast<const int8_t *>(data), length, missing_values, bits);
+            break;
+        case NC_SHORT:
+            validity_bits(static_cast<const int16_t *>(data), length, missing_values, bits);
+            break;
+        case NC_INT:
+            validity_bits(static_cast<const int32_t *>(data), length, missing_values, bits);
+            break;
+        case NC_FLOAT:
+            validity_bits(static_cast<const float *>(data), length, missing_values, bits);
+            break;
+        case NC_DOUBLE:
+            validity_bits(static_cast<const double *>(data), length, missing_values, bits);
+            break;
+        case NC_UBYTE:
+            validity_bits(static_cast<const uint8_t *>(data), length, missing_values, bits);
+            break;
+        case NC_USHORT:
+            validity_bits(static_cast<const uint16_t *>(data), length, missing_values, bits);
+            break;
+        case NC_UINT:
+            validity_bits(static_cast<const uint32_t *>(data), length, missing_values, bits);
+            break;
+        case NC_INT64:
+            if (type == NC_INT64 || type == NC_UINT64)
+                validity_bits(static_cast<const int64_t *>(data), length, missing_integers, bits);
+            else
+                validity_bits(static_cast<const int64_t *>(data), length, missing_values, bits);
+            break;
+        case NC_UINT64:
+            if (type == NC_INT64 || type == NC_UINT64)
+                validity_bits(static_cast<const uint64_t *>(data), length, missing_integers, bits);
+            else
+                validity_bits(static_cast<const uint64_t *>(data), length, missing_values, bits);
+            break;
+        }
+    }
+
+    static const std::vector<double> no_missing_values;
+    const std::vector<double> &missing = options.mask == Mask::NaN ? missing_values : no_missing_values;
+    if (options.output_type == NC_DOUBLE)
+        mask_and_unpack(static_cast<double *>(data), length, missing, options.unpack, scale_factor, add_offset);
+    else if (options.output_type == NC_FLOAT)
+        mask_and_unpack(static_cast<float *>(data), length, missing, options.unpack, scale_factor, add_offset);
+
+    v8::Local<v8::Object> values = make_typed_array(options.output_type, buffer, 0, length);
+    if (options.mask != Mask::Bitmap || values.IsEmpty())
+        return values;
+    v8::Local<v8::Context> context = isolate->GetCurrentContext();
+    v8::Local<v8::Object> result = v8::Object::New(isolate);
+    (void)result->CreateDataProperty(context, v8::String::NewFromUtf8Literal(isolate, "values"), values);
+    (void)result->CreateDataProperty(context, v8::String::NewFromUtf8Literal(isolate, "validity"),
+                                     v8::Uint8Array::New(validity, 0, validity->ByteLength()));
+    return result;
+}
+
+void Variable::ReadStrings(const v8::FunctionCallbackInfo<v8::Value> &args)
+{
+    v8::Isolate *isolate = args.GetIsolate();
+    v8::Local<v8::Context> context = isolate->GetCurrentContext();
+    Variable *obj = node::ObjectWrap::Unwrap<Variable>(args.Holder());
+    const char *name = obj->name.c_str();
+
+    if (obj->type != NC_STRING && obj->type != NC_CHAR)
+    {
+        char error_msg[256];
+        snprintf(error_msg, sizeof(error_msg),
+                 "Variable.readStrings() for '%s': Variable type %d is not string or char", name, obj->type);
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8(isolate, error_msg, v8::NewStringType::kNormal).ToLocalChecked()));
+        return;
+    }
+    // The last dimension of a char variable holds the characters of each string and is always read whole
+    const bool is_char = obj->type == NC_CHAR;
+    const int string_dims = is_char && obj->ndims > 0 ? obj->ndims - 1 : obj->ndims;
+    if (args.Length() != 2 * string_dims)
+    {
+        char error_msg[512];
+        snprintf(error_msg, sizeof(error_msg),
+                 "Variable.readStrings() for '%s': Wrong number of arguments. Expected %d pairs (pos,size) = %d "
+                 "arguments, but got %d",
+                 name, string_dims, 2 * string_dims, args.Length());
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8(isolate, error_msg, v8::NewStringType::kNormal).ToLocalChecked()));
+        return;
+    }
+
+    std::vector<size_t> pos(obj->ndims, 0);
+    std::vector<size_t> size(obj->ndims, 1);
+    size_t rows = 1;
+    for (int i = 0; i < string_dims; i++)
+    {
+        pos[i] = static_cast<size_t>(args[2 * i]->IntegerValue(context).ToChecked());
+        size[i] = static_cast<size_t>(args[2 * i + 1]->IntegerValue(context).ToChecked());
+        rows *= size[i];
+    }
+    const size_t width = is_char && obj->ndims > 0 ? obj->current_lengths()[obj->ndims - 1] : 1;
+    if (is_char && obj->ndims > 0)
+        size[obj->ndims - 1] = width;
+
+    // Offsets are Int32Array as in Arrow's utf8 layout, so the data is limited to 2 GiB
+    v8::Local<v8::ArrayBuffer> offsets = v8::ArrayBuffer::New(isolate, (rows + 1) * sizeof(int32_t));
+    auto *offset = static_cast<int32_t *>(offsets->Data());
+    v8::Local<v8::ArrayBuffer> buffer;
+    size_t total = 0;
+    int retval = NC_NOERR;
+    if (is_char)
+    {
+        // Each fixed-width row ends at its first NUL, then trailing blanks are dropped
+        std::vector<char> rows_data(rows * width);
+        std::vector<size_t> lengths(rows);
+        retval = nc_get_vara_text(obj->parent_id, obj->id, pos.data(), size.data(), rows_data.data());
+        for (size_t r = 0; retval == NC_NOERR && r < rows; r++)
+        {
+            const char *row = rows_data.data() + r * width;
+            const char *end = static_cast<const char *>(memchr(row, '\0', width));
+            size_t length = end == nullptr ? width : static_cast<size_t>(end - row);
+            while (length > 0 && row[length - 1] == ' ')
+                length--;
+            lengths[r] = length;
+            offset[r] = static_cast<int32_t>(total);
+            total += length;
+        }
+        if (retval == NC_NOERR && total <= static_cast<size_t>(std::numeric_limits<int32_t>::max()))
+        {
+            buffer = v8::ArrayBuffer::New(isolate, total);
+            auto *bytes = static_cast<char *>(buffer->Data());
+            for (size_t r = 0; r < rows; r++)
+                memcpy(bytes + offset[r], rows_data.data() + r * width, lengths[r]);
+        }
+    }
+    else
+    {
+        std::vector<char *> strings(rows, nullptr);
+        retval = nc_get_vara_string(obj->parent_id, obj->id, pos.data(), size.data(), strings.data());
+        if (retval == NC_NOERR)
+        {
+            for (size_t r = 0; r < rows; r++)
+            {
+                offset[r] = static_cast<int32_t>(total);
+                total += strings[r] == nullptr ? 0 : strlen(strings[r]);
+            }
+            if (total <= static_cast<size_t>(std::numeric_limits<int32_t>::max()))
+            {
+                buffer = v8::ArrayBuffer::New(isolate, total);
+                auto *bytes = static_cast<char *>(buffer->Data());
+                for (size_t r = 0; r < rows; r++)
+                    if (strings[r] != nullptr)
+                        memcpy(bytes + offset[r], strings[r], strlen(strings[r]));
+            }
+            // One call releases every string the library allocated
+            retval = nc_free_string(rows, strings.data());
+        }
+    }
+    if (retval != NC_NOERR)
+    {
+        throw_netcdf_error(isolate, retval);
+        return;
+    }
+    if (total > static_cast<size_t>(std::numeric_limits<int32_t>::max()))
+    {
+        char error_msg[256];
+        snprintf(error_msg, sizeof(error_msg),
+                 "Variable.readStrings() for '%s': %zu bytes of strings exceed the 2 GiB of Int32Array offsets", name,
+                 total);
+        isolate->ThrowException(v8::Exception::RangeError(
+            v8::String::NewFromUtf8(isolate, error_msg, v8::NewStringType::kNormal).ToLocalChecked()));
+        return;
+    }
+    offset[rows] = static_cast<int32_t>(total);
+
+    v8::Local<v8::Object> result = v8::Object::New(isolate);
+    (void)result->CreateDataProperty(context, v8::String::NewFromUtf8Literal(isolate, "data"),
+                                     v8::Uint8Array::New(buffer, 0, total));
+    (void)result->CreateDataProperty(context, v8::String::NewFromUtf8Literal(isolate, "offsets"),
+                                     v8::Int32Array::New(offsets, 0, rows + 1));
+    args.GetReturnValue().Set(result);
+}
+
+void Variable::ReadSliceInto(const v8::FunctionCallbackInfo<v8::Value> &args)
+{
+    ReadInto(args, "readSliceInto", false);
+}
+
+void Variable::ReadStridedSliceInto(const v8::FunctionCallbackInfo<v8::Value> &args)
+{
+    ReadInto(args, "readStridedSliceInto", true);
+}
+
+void Variable::ReadInto(const v8::FunctionCallbackInfo<v8::Value> &args, const char *method, bool strided)
+{
+    v8::Isolate *isolate = args.GetIsolate();
+    v8::Local<v8::Context> context = isolate->GetCurrentContext();
+    Variable *obj = node::ObjectWrap::Unwrap<Variable>(args.Holder());
+    const char *name = obj->name.c_str();
+
+    const int arity = strided ? 3 : 2;
+    const int expected = arity * obj->ndims + 1;
+    if (args.Length() != expected && args.Length() != expected + 1)
+    {
+        char error_msg[512];
+        snprintf(error_msg, sizeof(error_msg),
+                 "Variable.%s() for '%s': Wrong number of arguments. Expected %d %s + target [+ byteOffset] = %d or %d "
+                 "arguments, but got %d",
+                 method, name, obj->ndims, strided ? "triplets (pos,size,stride)" : "pairs (pos,size)", expected,
+                 expected + 1, args.Length());
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8(isolate, error_msg, v8::NewStringType::kNormal).ToLocalChecked()));
+        return;
+    }
+    if (!args[expected - 1]->IsTypedArray())
+    {
+        char error_msg[256];
+        snprintf(error_msg, sizeof(error_msg), "Variable.%s() for '%s': Target must be a typed array, but got %s",
+                 method, name, *v8::String::Utf8Value(isolate, args[expected - 1]->TypeOf(isolate)));
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8(isolate, error_msg, v8::NewStringType::kNormal).ToLocalChecked()));
+        return;
+    }
+    v8::Local<v8::TypedArray> target = v8::Local<v8::TypedArray>::Cast(args[expected - 1]);
+    const char *expected_type_name = nullptr;
+    if (!is_matching_array(obj->type, target, expected_type_name))
+    {
+        char error_msg[512];
+        if (expected_type_name == nullptr)
+            snprintf(error_msg, sizeof(error_msg),
+                     "Variable.%s() for '%s': Variable type %d not supported for read operations", method, name,
+                     obj->type);
+        else
+            snprintf(error_msg, sizeof(error_msg),
+                     "Variable.%s() for '%s': Target type mismatch. Variable type is %s, expected %s, but got %s",
+                     method, name, type_names[obj->type], expected_type_name,
+                     *v8::String::Utf8Value(isolate, target->GetConstructorName()));
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8(isolate, error_msg, v8::NewStringType::kNormal).ToLocalChecked()));
+        return;
+    }
+
+    const size_t element_size = type_sizes[obj->type];
+    int64_t byte_offset = 0;
+    if (args.Length() == expected + 1 && !args[expected]->IsUndefined())
+        byte_offset = args[expected]->IntegerValue(context).ToChecked();
+
+    std::vector<size_t> pos(obj->ndims);
+    std::vector<size_t> size(obj->ndims);
+    std::vector<ptrdiff_t> stride(strided ? obj->ndims : 0);
+    size_t total_size = 1;
+    for (int i = 0; i < obj->ndims; i++)
+    {
+        pos[i] = static_cast<size_t>(args[arity * i]->IntegerValue(context).ToChecked());
+        size[i] = static_cast<size_t>(args[arity * i + 1]->IntegerValue(context).ToChecked());
+        if (strided)
+            stride[i] = static_cast<ptrdiff_t>(args[arity * i + 2]->IntegerValue(context).ToChecked());
+        total_size *= size[i];
+    }
+
+    if (byte_offset < 0 || static_cast<size_t>(byte_offset) % element_size != 0 ||
+        static_cast<size_t>(byte_offset) + total_size * element_size > target->ByteLength())
+    {
+        char error_msg[512];
+        snprintf(error_msg, sizeof(error_msg),
+                 "Variable.%s() for '%s': Target too small or misaligned. Need %zu bytes at byteOffset %lld "
+                 "(multiple of %zu), but target has %zu bytes",
+                 method, name, total_size * element_size, static_cast<long long>(byte_offset), element_size,
+                 target->ByteLength());
+        isolate->ThrowException(v8::Exception::RangeError(
+            v8::String::NewFromUtf8(isolate, error_msg, v8::NewStringType::kNormal).ToLocalChecked()));
+        return;
+    }
+
+    void *data = static_cast<char *>(target->Buffer()->Data()) + target->ByteOffset() + byte_offset;
+    int retval = strided ? nc_get_vars(obj->parent_id, obj->id, pos.data(), size.data(), stride.data(), data)
+                         : nc_get_vara(obj->parent_id, obj->id, pos.data(), size.data(), data);
+    if (retval != NC_NOERR)
+    {
+        throw_netcdf_error(isolate, retval);
+        return;
+    }
+    args.GetReturnValue().Set(target);
+}
+
+std::vector<size_t> Variable::block_shape() noexcept
+{
+    if (storage == NC_CHUNKED)
+        return chunk_sizes;
+    // Unchunked data is stored row-major, so a row of the fastest-varying dimension is contiguous
+    std::vector<size_t> shape(ndims, 1);
+    if (ndims > 0)
+        shape[ndims - 1] = std::max<size_t>(current_lengths()[ndims - 1], 1);
+    return shape;
+}
+
+std::vector<size_t> Variable::io_tile(const std::vector<size_t> &start, const std::vector<size_t> &count,
+                                     size_t max_bytes) noexcept
+{
+    std::vector<size_t> tile = block_shape();
+    size_t bytes = element_size() * box_size(tile);
+    if (storage != NC_CHUNKED && ndims > 0 && bytes > max_bytes)
+    {
+        tile[ndims - 1] = std::max<size_t>(max_bytes / element_size(), 1);
+        bytes = element_size() * tile[ndims - 1];
+    }
+    // Merge whole blocks, fastest dimension first, while the result fits in max_bytes
+    for (int d = ndims - 1; d >= 0; d--)
+    {
+        const size_t span = count[d] == 0 ? 1 : (start[d] + count[d] - 1) / tile[d] - start[d] / tile[d] + 1;
+        const size_t factor = std::min(span, std::max<size_t>(max_bytes / bytes, 1));
+        tile[d] *= factor;
+        bytes *= factor;
+        if (factor < span)
+            break;
+    }
+    return tile;
+}
+
+std::vector<size_t> Variable::stream_tile(const std::vector<size_t> &start, const std::vector<size_t> &count,
+                                         size_t max_bytes, std::vector<size_t> &origin) noexcept
+{
+    // Consecutive blocks only concatenate to C order if every dimension inside the split one is whole
+    const std::vector<size_t> block = block_shape();
+    std::vector<size_t> tile(ndims, 1);
+    origin.assign(start.begin(), start.end());
+    size_t bytes = element_size();
+    for (int d = ndims - 1; d >= 0; d--)
+    {
+        const size_t extent = std::max<size_t>(count[d], 1);
+        if (bytes * extent <= max_bytes)
+        {
+            tile[d] = extent;
+            bytes *= extent;
+            continue;
+        }
+        // Split on the chunk grid where a block holds at least one chunk row
+        size_t rows = std::max<size_t>(max_bytes / bytes, 1);
+        if (rows >= block[d])
+        {
+            rows -= rows % block[d];
+            origin[d] = 0;
+        }
+        tile[d] = rows;
+        break;
+    }
+    return tile;
+}
+
+bool Variable::get_coords(v8::Isolate *isolate, v8::Local<v8::Value> value, const char *method,
+                          std::vector<size_t> &coords)
+{
+    char error_msg[512];
+    if (ndims == 0 || !value->IsTypedArray())
+    {
+        snprintf(error_msg, sizeof(error_msg),
+                 ndims == 0 ? "Variable.%s() for '%s': Scalar variables have no coordinates"
+                            : "Variable.%s() for '%s': Coordinates must be an Int32Array, Uint32Array, BigInt64Array or "
+                              "BigUint64Array",
+                 method, name.c_str());
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8(isolate, error_msg, v8::NewStringType::kNormal).ToLocalChecked()));
+        return false;
+    }
+    v8::Local<v8::TypedArray> array = v8::Local<v8::TypedArray>::Cast(value);
+    const size_t length = array->Length();
+    if (length % ndims != 0)
+    {
+        snprintf(error_msg, sizeof(error_msg),
+                 "Variable.%s() for '%s': Coordinate array length %zu is not a multiple of the %d dimensions", method,
+                 name.c_str(), length, ndims);
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8(isolate, error_msg, v8::NewStringType::kNormal).ToLocalChecked()));
+        return false;
+    }
+
+    coords.resize(length);
+    const char *data = static_cast<const char *>(array->Buffer()->Data()) + array->ByteOffset();
+    // Negative coordinates wrap to at least 2^63, so the bounds check below names the point holding them
+    if (array->IsInt32Array() || array->IsUint32Array())
+    {
+        const bool is_signed = array->IsInt32Array();
+        for (size_t i = 0; i < length; i++)
+        {
+            int32_t v;
+            memcpy(&v, data + i * sizeof(v), sizeof(v));
+            coords[i] = is_signed ? static_cast<size_t>(static_cast<int64_t>(v)) : static_cast<uint32_t>(v);
+        }
+    }
+    else if (array->IsBigInt64Array() || array->IsBigUint64Array())
+    {
+        for (size_t i = 0; i < length; i++)
+        {
+            int64_t v;
+            memcpy(&v, data + i * sizeof(v), sizeof(v));
+            coords[i] = static_cast<size_t>(v);
+        }
+    }
+    else
+    {
+        snprintf(error_msg, sizeof(error_msg),
+                 "Variable.%s() for '%s': Coordinates must be an Int32Array, Uint32Array, BigInt64Array or "
+                 "BigUint64Array, but got %s",
+                 method, name.c_str(), *v8::String::Utf8Value(isolate, array->GetConstructorName()));
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8(isolate, error_msg, v8::NewStringType::kNormal).ToLocalChecked()));
+        return false;
+    }
+
+    const std::vector<size_t> &shape = current_lengths();
+    for (size_t i = 0; i < length; i++)
+    {
+        if (coords[i] >= shape[i % ndims])
+        {
+            snprintf(error_msg, sizeof(error_msg),
+                     "Variable.%s() for '%s': Point %zu is out of bounds in dimension %zu (length %zu)", method,
+                     name.c_str(), i / ndims, i % ndims, shape[i % ndims]);
+            isolate->ThrowException(v8::Exception::RangeError(
+                v8::String::NewFromUtf8(isolate, error_msg, v8::NewStringType::kNormal).ToLocalChecked()));
+            return false;
+        }
+    }
+    return true;
+}
+
+std::vector<size_t> Variable::sort_by_block(const std::vector<size_t> &coords, const std::vector<size_t> &block) const
+{
+    const size_t npoints = coords.size() / ndims;
+    std::vector<size_t> order(npoints);
+    for (size_t i = 0; i < npoints; i++)
+        order[i] = i;
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        for (int d = 0; d < ndims; d++)
+        {
+            const size_t ca = coords[a * ndims + d] / block[d];
+            const size_t cb = coords[b * ndims + d] / block[d];
+            if (ca != cb)
+                return ca < cb;
+        }
+        return false;
+    });
+    return order;
+}
+
+void Variable::ReadPoints(const v8::FunctionCallbackInfo<v8::Value> &args)
+{
+    v8::Isolate *isolate = args.GetIsolate();
+    Variable *obj = node::ObjectWrap::Unwrap<Variable>(args.Holder());
+    const char *name = obj->name.c_str();
+
+    if (args.Length() != 1)
+    {
+        char error_msg[256];
+        snprintf(error_msg, sizeof(error_msg),
+                 "Variable.readPoints() for '%s': Wrong number of arguments. Expected 1 (coordinates), but got %d",
+                 name, args.Length());
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8(isolate, error_msg, v8::NewStringType::kNormal).ToLocalChecked()));
+        return;
+    }
+    if (obj->type < NC_BYTE || obj->type > NC_UINT64)
+    {
+        char error_msg[256];
+        snprintf(error_msg, sizeof(error_msg),
+                 "Variable.readPoints() for '%s': Variable type %d not supported for read operations", name,
+                 obj->type);
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8(isolate, error_msg, v8::NewStringType::kNormal).ToLocalChecked()));
+        return;
+    }
+    std::vector<size_t> coords;
+    if (!obj->get_coords(isolate, args[0], "readPoints", coords))
+        return;
+
+    const int ndims = obj->ndims;
+    const size_t element_size = type_sizes[obj->type];
+    const size_t npoints = coords.size() / ndims;
+    const std::vector<size_t> block = obj->block_shape();
+    const std::vector<size_t> order = obj->sort_by_block(coords, block);
+
+    v8::Local<v8::ArrayBuffer> buffer = v8::ArrayBuffer::New(isolate, npoints * element_size);
+    char *out = static_cast<char *>(buffer->Data());
+    std::vector<char> scratch;
+    std::vector<size_t> start(ndims);
+    std::vector<size_t> count(ndims);
+
+    // Points are visited block by block; each touched block is read with a single nc_get_vara
+    for (size_t first = 0; first < npoints;)
+    {
+        const size_t last = next_block_run(coords, order, block, first, start, count);
+        int retval;
+        if (last - first == 1)
+            retval = nc_get_var1(obj->parent_id, obj->id, start.data(), out + order[first] * element_size);
+        else
+        {
+            scratch.resize(box_size(count) * element_size);
+            retval = nc_get_vara(obj->parent_id, obj->id, start.data(), count.data(), scratch.data());
+            for (size_t i = first; retval == NC_NOERR && i < last; i++)
+            {
+                const size_t offset = box_offset(&coords[order[i] * ndims], start, count);
+                memcpy(out + order[i] * element_size, scratch.data() + offset * element_size, element_size);
+            }
+        }
+        if (retval != NC_NOERR)
+        {
+            throw_netcdf_error(isolate, retval);
+            return;
+        }
+        first = last;
+    }
+    args.GetReturnValue().Set(make_typed_array(obj->type, buffer, 0, npoints));
+}
+
+void Variable::WritePoints(const v8::FunctionCallbackInfo<v8::Value> &args)
+{
+    v8::Isolate *isolate = args.GetIsolate();
+    Variable *obj = node::ObjectWrap::Unwrap<Variable>(args.Holder());
+    const char *name = obj->name.c_str();
+
+    if (args.Length() != 2)
+    {
+        char error_msg[256];
+        snprintf(error_msg, sizeof(error_msg),
+                 "Variable.writePoints() for '%s': Wrong number of arguments. Expected 2 (coordinates, values), but "
+                 "got %d",
+                 name, args.Length());
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8(isolate, error_msg, v8::NewStringType::kNormal).ToLocalChecked()));
+        return;
+    }
+    std::vector<size_t> coords;
+    if (!obj->get_coords(isolate, args[0], "writePoints", coords))
+        return;
+
+    const int ndims = obj->ndims;
+    const size_t npoints = coords.size() / ndims;
+    const char *expected_type_name = nullptr;
+    if (!args[1]->IsTypedArray() ||
+        !is_matching_array(obj->type, v8::Local<v8::TypedArray>::Cast(args[1]), expected_type_name) ||
+        v8::Local<v8::TypedArray>::Cast(args[1])->Length() != npoints)
+    {
+        char error_msg[512];
+        if (expected_type_name == nullptr && args[1]->IsTypedArray())
+            snprintf(error_msg, sizeof(error_msg),
+                     "Variable.writePoints() for '%s': Variable type %d not supported for write operations", name,
+                     obj->type);
+        else
+            snprintf(error_msg, sizeof(error_msg),
+                     "Variable.writePoints() for '%s': Values must be a %s of %zu elements (one per point)", name,
+                     expected_type_name ? expected_type_name : "typed array matching the variable type", npoints);
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8(isolate, error_msg, v8::NewStringType::kNormal).ToLocalChecked()));
+        return;
+    }
+    v8::Local<v8::TypedArray> values = v8::Local<v8::TypedArray>::Cast(args[1]);
+    const char *in = static_cast<const char *>(values->Buffer()->Data()) + values->ByteOffset();
+
+    const size_t element_size = type_sizes[obj->type];
+    const std::vector<size_t> block = obj->block_shape();
+    const std::vector<size_t> order = obj->sort_by_block(coords, block);
+    std::vector<char> scratch;
+    std::vector<size_t> start(ndims);
+    std::vector<size_t> count(ndims);
+
+    // Each touched chunk is read, patched and written back once; the sort is stable, so later duplicates win.
+    // Unchunked blocks are whole rows, where a read-modify-write would rewrite far more than the points
+    const bool patch_blocks = obj->storage == NC_CHUNKED;
+    for (size_t first = 0; first < npoints;)
+    {
+        const size_t last = next_block_run(coords, order, block, first, start, count);
+        int retval = NC_NOERR;
+        if (last - first == 1)
+            retval = nc_put_var1(obj->parent_id, obj->id, start.data(), in + order[first] * element_size);
+        else if (!patch_blocks)
+        {
+            for (size_t i = first; retval == NC_NOERR && i < last; i++)
+                retval = nc_put_var1(obj->parent_id, obj->id, &coords[order[i] * ndims], in + order[i] * element_size);
+        }
+        else
+        {
+            scratch.resize(box_size(count) * element_size);
+            retval = nc_get_vara(obj->parent_id, obj->id, start.data(), count.data(), scratch.data());
+            for (size_t i = first; retval == NC_NOERR && i < last; i++)
+            {
+                const size_t offset = box_offset(&coords[order[i] * ndims], start, count);
+                memcpy(scratch.data() + offset * element_size, in + order[i] * element_size, element_size);
+            }
+            if (retval == NC_NOERR)
+                retval = nc_put_vara(obj->parent_id, obj->id, start.data(), count.data(), scratch.data());
+        }
+        if (retval != NC_NOERR)
+        {
+            throw_netcdf_error(isolate, retval);
+            return;
+        }
+        first = last;
+    }
+}
+
+void Variable::AppendRecords(const v8::FunctionCallbackInfo<v8::Value> &args)
+{
+    v8::Isolate *isolate = args.GetIsolate();
+    Variable *obj = node::ObjectWrap::Unwrap<Variable>(args.Holder());
+    (void)obj->append_records(isolate, args.Length() == 1 ? args[0] : v8::Undefined(isolate).As<v8::Value>(),
+                              "appendRecords");
+}
+
+void Variable::CreateAppendStream(const v8::FunctionCallbackInfo<v8::Value> &args)
+{
+    v8::Isolate *isolate = args.GetIsolate();
+    v8::Local<v8::Context> context = isolate->GetCurrentContext();
+    Variable *obj = node::ObjectWrap::Unwrap<Variable>(args.Holder());
+    char error_msg[512];
+
+    if (obj->ndims == 0 || !obj->unlimited[0])
+    {
+        snprintf(error_msg, sizeof(error_msg),
+                 "Variable.createAppendStream() for '%s': The first dimension must be unlimited", obj->name.c_str());
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8(isolate, error_msg, v8::NewStringType::kNormal).ToLocalChecked()));
+        return;
+    }
+    if (writable.IsEmpty())
+    {
+        isolate->ThrowException(v8::Exception::Error(
+            v8::String::NewFromUtf8Literal(isolate, "stream.Writable is not available in this environment")));
+        return;
+    }
+    v8::Local<v8::Object> self = args.Holder();
+    v8::Local<v8::Object> options = v8::Object::New(isolate);
+    (void)options->CreateDataProperty(context, v8::String::NewFromUtf8Literal(isolate, "objectMode"),
+                                      v8::True(isolate));
+    (void)options->CreateDataProperty(context, v8::String::NewFromUtf8Literal(isolate, "write"),
+                                      v8::Function::New(context, AppendStreamWrite, self).ToLocalChecked());
+    (void)options->CreateDataProperty(context, v8::String::NewFromUtf8Literal(isolate, "final"),
+                                      v8::Function::New(context, AppendStreamFinal, self).ToLocalChecked());
+    v8::Local<v8::Value> argv[] = {options};
+    v8::Local<v8::Object> stream;
+    if (v8::Local<v8::Function>::New(isolate, writable)->NewInstance(context, 1, argv).ToLocal(&stream))
+        args.GetReturnValue().Set(stream);
+}
+
+void Variable::AppendStreamWrite(const v8::FunctionCallbackInfo<v8::Value> &args)
+{
+    v8::Isolate *isolate = args.GetIsolate();
+    v8::Local<v8::Context> context = isolate->GetCurrentContext();
+    Variable *obj = node::ObjectWrap::Unwrap<Variable>(args.Data().As<v8::Object>());
+    v8::Local<v8::Value> error = v8::Undefined(isolate);
+    {
+        // Called by the stream, not through a serialized<> binding
+        const std::lock_guard<std::recursive_mutex> lock(netcdf_mutex());
+        v8::TryCatch try_catch(isolate);
+        if (!obj->append_records(isolate, args[0], "createAppendStream") && try_catch.HasCaught())
+            error = try_catch.Exception();
+    }
+    if (args.Length() > 2 && args[2]->IsFunction())
+        (void)args[2].As<v8::Function>()->Call(context, v8::Undefined(isolate), 1, &error);
+}
+
+void Variable::AppendStreamFinal(const v8::FunctionCallbackInfo<v8::Value> &args)
+{
+    v8::Isolate *isolate = args.GetIsolate();
+    v8::Local<v8::Context> context = isolate->GetCurrentContext();
+    Variable *obj = node::ObjectWrap::Unwrap<Variable>(args.Data().As<v8::Object>());
+    v8::Local<v8::Value> error = v8::Undefined(isolate);
+    {
+        const std::lock_guard<std::recursive_mutex> lock(netcdf_mutex());
+        if (const int retval = obj->flush_records(true); retval != NC_NOERR)
+        {
+            obj->drop_records();
+            error = netcdf_error(isolate, retval);
+        }
+    }
+    if (args.Length() > 0 && args[0]->IsFunction())
+        (void)args[0].As<v8::Function>()->Call(context, v8::Undefined(isolate), 1, &error);
+}
+
+bool Variable::append_records(v8::Isolate *isolate, v8::Local<v8::Value> records, const char *method)
+{
+    const char *var_name = name.c_str();
+    char error_msg[512];
+
+    if (!records->IsTypedArray())
+    {
+        snprintf(error_msg, sizeof(error_msg), "Variable.%s() for '%s': Expected one typed array of records", method,
+                 var_name);
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8(isolate, error_msg, v8::NewStringType::kNormal).ToLocalChecked()));
+        return false;
+    }
+    if (ndims == 0 || !unlimited[0])
+    {
+        snprintf(error_msg, sizeof(error_msg), "Variable.%s() for '%s': The first dimension must be unlimited", method,
+                 var_name);
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8(isolate, error_msg, v8::NewStringType::kNormal).ToLocalChecked()));
+        return false;
+    }
+    v8::Local<v8::TypedArray> val = records.As<v8::TypedArray>();
+    const char *expected_type_name = nullptr;
+    if (!is_matching_array(type, val, expected_type_name))
+    {
+        v8::String::Utf8Value actual_type(isolate, val->GetConstructorName());
+        if (expected_type_name == nullptr)
+            snprintf(error_msg, sizeof(error_msg),
+                     "Variable.%s() for '%s': Variable type %d (%s) not supported for write operations",
+                     method, var_name, type, type_name().c_str());
+        else
+            snprintf(error_msg, sizeof(error_msg),
+                     "Variable.%s() for '%s': Array type mismatch. Variable type is %s, expected %s array, but got %s",
+                     method, var_name, type_names[type], expected_type_name, *actual_type);
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8(isolate, error_msg, v8::NewStringType::kNormal).ToLocalChecked()));
+        return false;
+    }
+    const std::vector<size_t> &shape = current_lengths();
+    size_t record_size = 1;
+    for (int d = 1; d < ndims; d++)
+        record_size *= shape[d];
+    if (record_size == 0 || val->Length() % record_size != 0)
+    {
+        snprintf(error_msg, sizeof(error_msg),
+                 "Variable.%s() for '%s': Array length %zu is not a multiple of the record size %zu", method,
+                 var_name, val->Length(), record_size);
+        isolate->ThrowException(v8::Exception::RangeError(
+            v8::String::NewFromUtf8(isolate, error_msg, v8::NewStringType::kNormal).ToLocalChecked()));
+        return false;
+    }
+    if (val->Length() == 0)
+        return true;
+
+    if (append_count == 0)
+    {
+        // The first append along a dimension starts at its end; every variable then continues where it left off
+        const int file = file_of(parent_id);
+        AppendOrigin &origin = append_origins().try_emplace({file, dimids[0]}, AppendOrigin{shape[0], shape[0]})
+                                   .first->second;
+        const bool idle = std::none_of(appending().begin(), appending().end(), [&](const Variable *variable) {
+            return file_of(variable->parent_id) == file && variable->dimids[0] == dimids[0];
+        });
+        if (idle && shape[0] > origin.end)
+            origin = AppendOrigin{shape[0], shape[0]};
+        // A cursor left behind by an earlier origin would overwrite the records written since
+        append_start =
+            std::max(append_cursors().try_emplace({parent_id, id}, origin.start).first->second, origin.start);
+        appending().push_back(this);
+        Ref();
+    }
+    const auto *data = static_cast<const uint8_t *>(val->Buffer()->Data()) + val->ByteOffset();
+    append_buffer.insert(append_buffer.end(), data, data + val->ByteLength());
+    append_count += val->Length() / record_size;
+    if (const int retval = flush_records(false); retval != NC_NOERR)
+    {
+        // Keeping the records would append them a second time when the caller retries
+        drop_records();
+        throw_netcdf_error(isolate, retval);
+        return false;
+    }
+    return true;
+}
+
+int Variable::flush_records(bool all) noexcept
+{
+    const size_t chunk = storage == NC_CHUNKED ? chunk_sizes[0] : 1;
+    const size_t end = all ? append_start + append_count : (append_start + append_count) / chunk * chunk;
+    if (end <= append_start)
+        return NC_NOERR;
+
+    std::vector<size_t> start(ndims, 0);
+    std::vector<size_t> count = current_lengths();
+    start[0] = append_start;
+    count[0] = end - append_start;
+    const int retval = nc_put_vara(parent_id, id, start.data(), count.data(), append_buffer.data());
+    if (retval != NC_NOERR)
+        return retval;
+
+    append_buffer.erase(append_buffer.begin(),
+                        append_buffer.begin() + static_cast<ptrdiff_t>(append_buffer.size() / append_count * count[0]));
+    append_count -= count[0];
+    append_start = end;
+    append_cursors()[{parent_id, id}] = end;
+    AppendOrigin &origin = append_origins()[{file_of(parent_id), dimids[0]}];
+    origin.end = std::max(origin.end, end);
+    if (append_count == 0)
+    {
+        std::erase(appending(), this);
+        Unref();
+    }
+    return NC_NOERR;
+}
+
+void Variable::drop_records() noexcept
+{
+    if (append_count == 0)
+        return;
+    append_buffer.clear();
+    append_count = 0;
+    std::erase(appending(), this);
+    Unref();
+}
+
+int Variable::flush_appends(int ncid, bool closing) noexcept
+{
+    const int file = file_of(ncid);
+    int result = NC_NOERR;
+    // flush_records() removes finished variables from the list, so iterate over a copy
+    const std::vector<Variable *> pending = appending();
+    for (Variable *variable : pending)
+    {
+        if (file_of(variable->parent_id) != file)
+            continue;
+        const int retval = variable->flush_records(true);
+        if (retval == NC_NOERR)
+            continue;
+        if (result == NC_NOERR)
+            result = retval;
+        if (closing)
+            variable->drop_records();
+    }
+    if (closing)
+    {
+        const auto in_file = [file](const auto &entry) { return file_of(entry.first.first) == file; };
+        std::erase_if(append_cursors(), in_file);
+        std::erase_if(append_origins(), in_file);
+    }
+    return result;
+}
+
+std::map<std::pair<int, int>, size_t> &Variable::append_cursors() noexcept
+{
+    static std::map<std::pair<int, int>, size_t> cursors;
+    return cursors;
+}
+
+std::map<std::pair<int, int>, Variable::AppendOrigin> &Variable::append_origins() noexcept
+{
+    static std::map<std::pair<int, int>, AppendOrigin> origins;
+    return origins;
+}
+
+size_t Variable::buffered_length(int ncid, int dimid) noexcept
+{
+    const int file = file_of(ncid);
+    size_t length = 0;
+    for (const Variable *variable : appending())
+    {
+        if (file_of(variable->parent_id) == file && variable->dimids[0] == dimid)
+            length = std::max(length, variable->append_start + variable->append_count);
+    }
+    return length;
+}
+
+std::vector<Variable *> &Variable::appending() noexcept
+{
+    static std::vector<Variable *> variables;
+    return variables;
+}
+
+bool Variable::get_index_array(v8::Isolate *isolate, v8::Local<v8::Object> options, const char *key,
+                               const char *method, std::vector<size_t> &indices)
+{
+    v8::Local<v8::Context> context = isolate->GetCurrentContext();
+    v8::Local<v8::Value> value = options->Get(context, v8::String::NewFromUtf8(isolate, key).ToLocalChecked())
+                                     .ToLocalChecked();
+    if (value->IsUndefined())
+        return true;
+    if (!value->IsArray())
+    {
+        char error_msg[256];
+        snprintf(error_msg, sizeof(error_msg), "Variable.%s() for '%s': %s must be an array", method, name.c_str(),
+                 key);
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8(isolate, error_msg, v8::NewStringType::kNormal).ToLocalChecked()));
+        return false;
+    }
+    v8::Local<v8::Array> array = value.As<v8::Array>();
+    indices.resize(array->Length());
+    for (uint32_t i = 0; i < array->Length(); i++)
+    {
+        const int64_t v = array->Get(context, i).ToLocalChecked()->IntegerValue(context).FromMaybe(-1);
+        if (v < 0)
+        {
+            char error_msg[256];
+            snprintf(error_msg, sizeof(error_msg), "Variable.%s() for '%s': %s[%u] must be a non-negative integer",
+                     method, name.c_str(), key, i);
+            isolate->ThrowException(v8::Exception::RangeError(
+                v8::String::NewFromUtf8(isolate, error_msg, v8::NewStringType::kNormal).ToLocalChecked()));
+            return false;
+        }
+        indices[i] = static_cast<size_t>(v);
+    }
+    return true;
+}
+
+bool Variable::get_hyperslab(v8::Isolate *isolate, v8::Local<v8::Object> options, const char *method,
+                             std::vector<size_t> &start, std::vector<size_t> &count)
+{
+    const std::vector<size_t> &shape = current_lengths();
+    start.assign(ndims, 0);
+    count.clear();
+    if (!get_index_array(isolate, options, "start", method, start) ||
+        !get_index_array(isolate, options, "count", method, count))
+        return false;
+    if (count.empty() && ndims > 0)
+    {
+        count.resize(ndims);
+        for (int d = 0; d < ndims && start.size() == static_cast<size_t>(ndims); d++)
+            count[d] = shape[d] > start[d] ? shape[d] - start[d] : 0;
+    }
+    char error_msg[512];
+    if (start.size() != static_cast<size_t>(ndims) || count.size() != static_cast<size_t>(ndims))
+    {
+        snprintf(error_msg, sizeof(error_msg), "Variable.%s() for '%s': start and count need %d entries", method,
+                 name.c_str(), ndims);
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8(isolate, error_msg, v8::NewStringType::kNormal).ToLocalChecked()));
+        return false;
+    }
+    for (int d = 0; d < ndims; d++)
+    {
+        if (start[d] + count[d] > shape[d])
+        {
+            snprintf(error_msg, sizeof(error_msg),
+                     "Variable.%s() for '%s': Slice [%zu, %zu) out of bounds in dimension %d (length %zu)", method,
+                     name.c_str(), start[d], start[d] + count[d], d, shape[d]);
+            isolate->ThrowException(v8::Exception::RangeError(
+                v8::String::NewFromUtf8(isolate, error_msg, v8::NewStringType::kNormal).ToLocalChecked()));
+            return false;
+        }
+    }
+    return true;
+}
+
+void Variable::Reduce(const v8::FunctionCallbackInfo<v8::Value> &args)
+{
+    v8::Isolate *isolate = args.GetIsolate();
+    v8::Local<v8::Context> context = isolate->GetCurrentContext();
+    Variable *obj = node::ObjectWrap::Unwrap<Variable>(args.Holder());
+    const char *name = obj->name.c_str();
+    const int ndims = obj->ndims;
+    char error_msg[512];
+
+    if (args.Length() > 1 || (args.Length() == 1 && !args[0]->IsObject()))
+    {
+        snprintf(error_msg, sizeof(error_msg),
+                 "Variable.reduce() for '%s': Expected one options object { start, count, ops, axes, unpack }", name);
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8(isolate, error_msg, v8::NewStringType::kNormal).ToLocalChecked()));
+        return;
+    }
+    if (obj->type < NC_BYTE || obj->type > NC_UINT64)
+    {
+        snprintf(error_msg, sizeof(error_msg),
+                 "Variable.reduce() for '%s': Variable type %d not supported for read operations", name, obj->type);
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8(isolate, error_msg, v8::NewStringType::kNormal).ToLocalChecked()));
+        return;
+    }
+    v8::Local<v8::Object> options = args.Length() == 1 ? args[0].As<v8::Object>() : v8::Object::New(isolate);
+
+    // Defaults: the whole variable, every statistic, reduced over all axes
+    std::vector<size_t> start;
+    std::vector<size_t> count;
+    std::vector<size_t> axes;
+    if (!obj->get_hyperslab(isolate, options, "reduce", start, count) ||
+        !obj->get_index_array(isolate, options, "axes", "reduce", axes))
+        return;
+    std::vector<bool> kept(ndims, true);
+    if (!options->Has(context, v8::String::NewFromUtf8Literal(isolate, "axes")).FromMaybe(false))
+        kept.assign(ndims, false);
+    for (const size_t axis : axes)
+    {
+        if (axis >= static_cast<size_t>(ndims))
+        {
+            snprintf(error_msg, sizeof(error_msg), "Variable.reduce() for '%s': Axis %zu out of range for %d dimensions",
+                     name, axis, ndims);
+            isolate->ThrowException(v8::Exception::RangeError(
+                v8::String::NewFromUtf8(isolate, error_msg, v8::NewStringType::kNormal).ToLocalChecked()));
+            return;
+        }
+        kept[axis] = false;
+    }
+
+    static constexpr std::array<const char *, 5> op_names = {"min", "max", "sum", "mean", "count"};
+    std::array<bool, op_names.size()> ops{};
+    v8::Local<v8::Value> ops_value = options->Get(context, v8::String::NewFromUtf8Literal(isolate, "ops")).ToLocalChecked();
+    if (ops_value->IsUndefined())
+        ops.fill(true);
+    else if (ops_value->IsArray())
+    {
+        v8::Local<v8::Array> array = ops_value.As<v8::Array>();
+        for (uint32_t i = 0; i < array->Length(); i++)
+        {
+            const std::string op = *v8::String::Utf8Value(isolate, array->Get(context, i).ToLocalChecked());
+            const auto found = std::find_if(op_names.begin(), op_names.end(), [&](const char *n) { return op == n; });
+            if (found == op_names.end())
+            {
+                snprintf(error_msg, sizeof(error_msg),
+                         "Variable.reduce() for '%s': Unknown op '%s'. Valid ops are: min, max, sum, mean, count", name,
+                         op.c_str());
+                isolate->ThrowException(v8::Exception::TypeError(
+                    v8::String::NewFromUtf8(isolate, error_msg, v8::NewStringType::kNormal).ToLocalChecked()));
+                return;
+            }
+            ops[found - op_names.begin()] = true;
+        }
+    }
+    else
+    {
+        snprintf(error_msg, sizeof(error_msg), "Variable.reduce() for '%s': ops must be an array", name);
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8(isolate, error_msg, v8::NewStringType::kNormal).ToLocalChecked()));
+        return;
+    }
+
+    const bool unpack =
+        options->Get(context, v8::String::NewFromUtf8Literal(isolate, "unpack")).ToLocalChecked()->BooleanValue(isolate);
+    int retval = obj->missing_loaded ? NC_NOERR : obj->load_missing_values();
+    if (retval == NC_NOERR && unpack && !obj->packing_loaded)
+        retval = obj->load_packing();
+    if (retval != NC_NOERR)
+    {
+        throw_netcdf_error(isolate, retval);
+        return;
+    }
+    const double scale_factor = unpack ? obj->scale_factor : 1.0;
+    const double add_offset = unpack ? obj->add_offset : 0.0;
+
+    size_t result_size = 1;
+    for (int d = 0; d < ndims; d++)
+        if (kept[d])
+            result_size *= count[d];
+    std::vector<Accumulator> acc(result_size);
+
+    // Walk the slice one storage block at a time so peak memory is a single chunk
+    std::vector<size_t> block = obj->block_shape();
+    if (obj->storage != NC_CHUNKED && ndims > 0)
+        block[ndims - 1] = std::min<size_t>(block[ndims - 1], 1 << 20);
+    bool empty = false;
+    std::vector<size_t> first_tile(ndims);
+    std::vector<size_t> last_tile(ndims);
+    for (int d = 0; d < ndims; d++)
+    {
+        empty |= count[d] == 0;
+        first_tile[d] = start[d] / block[d];
+        last_tile[d] = count[d] == 0 ? first_tile[d] : (start[d] + count[d] - 1) / block[d];
+    }
+    std::vector<size_t> tile = first_tile;
+    std::vector<size_t> tile_start(ndims);
+    std::vector<size_t> tile_count(ndims);
+    std::vector<size_t> row(ndims);
+    std::vector<double> scratch;
+    const size_t acc_step = ndims > 0 && kept[ndims - 1] ? 1 : 0;
+    while (!empty)
+    {
+        for (int d = 0; d < ndims; d++)
+        {
+            tile_start[d] = std::max(start[d], tile[d] * block[d]);
+            tile_count[d] = std::min(start[d] + count[d], (tile[d] + 1) * block[d]) - tile_start[d];
+        }
+        scratch.resize(box_size(tile_count));
+        retval = get_vars_as(obj->parent_id, obj->id, NC_DOUBLE, tile_start.data(), tile_count.data(), nullptr,
+                             scratch.data());
+        if (retval != NC_NOERR)
+        {
+            throw_netcdf_error(isolate, retval);
+            return;
+        }
+
+        // Each row of the fastest dimension folds into one accumulator, or one per element if that axis is kept
+        const size_t inner = ndims > 0 ? tile_count[ndims - 1] : 1;
+        std::fill(row.begin(), row.end(), 0);
+        for (size_t r = 0; r < scratch.size() / inner; r++)
+        {
+            size_t out = 0;
+            for (int d = 0; d < ndims; d++)
+                if (kept[d])
+                    out = out * count[d] + (tile_start[d] + row[d] - start[d]);
+            accumulate(&scratch[r * inner], inner, obj->missing_values, &acc[out], acc_step, scale_factor,
+                       add_offset);
+            for (int d = ndims - 2; d >= 0; d--)
+            {
+                if (++row[d] < tile_count[d])
+                    break;
+                row[d] = 0;
+            }
+        }
+
+        int d = ndims - 1;
+        for (; d >= 0; d--)
+        {
+            if (++tile[d] <= last_tile[d])
+                break;
+            tile[d] = first_tile[d];
+        }
+        if (d < 0)
+            break;
+    }
+
+    v8::Local<v8::Object> result = v8::Object::New(isolate);
+    v8::Local<v8::Array> result_shape = v8::Array::New(isolate);
+    for (int d = 0, i = 0; d < ndims; d++)
+        if (kept[d])
+            (void)result_shape->Set(context, i++, v8::Number::New(isolate, static_cast<double>(count[d])));
+    (void)result->CreateDataProperty(context, v8::String::NewFromUtf8Literal(isolate, "shape"), result_shape);
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    for (size_t op = 0; op < op_names.size(); op++)
+    {
+        if (!ops[op])
+            continue;
+        v8::Local<v8::ArrayBuffer> buffer = v8::ArrayBuffer::New(isolate, result_size * sizeof(double));
+        auto *out = static_cast<double *>(buffer->Data());
+        for (size_t i = 0; i < result_size; i++)
+        {
+            const Accumulator &a = acc[i];
+            switch (op)
+            {
+            case 0:
+                out[i] = a.count > 0 ? a.min : nan;
+                break;
+            case 1:
+                out[i] = a.count > 0 ? a.max : nan;
+                break;
+            case 2:
+                out[i] = a.sum;
+                break;
+            case 3:
+                out[i] = a.count > 0 ? a.sum / a.count : nan;
+                break;
+            default:
+                out[i] = a.count;
+                break;
+            }
+        }
+        (void)result->CreateDataProperty(context,
+                                         v8::String::NewFromUtf8(isolate, op_names[op], v8::NewStringType::kInternalized)
+                                             .ToLocalChecked(),
+                                         v8::Float64Array::New(buffer, 0, result_size));
+    }
+    args.GetReturnValue().Set(result);
+}
+
+void Variable::Chunks(const v8::FunctionCallbackInfo<v8::Value> &args)
+{
+    v8::Isolate *isolate = args.GetIsolate();
+    v8::Local<v8::Context> context = isolate->GetCurrentContext();
+    Variable *obj = node::ObjectWrap::Unwrap<Variable>(args.Holder());
+    const char *name = obj->name.c_str();
+    char error_msg[512];
+
+    if (args.Length() > 1 || (args.Length() == 1 && !args[0]->IsObject()))
+    {
+        snprintf(error_msg, sizeof(error_msg),
+                 "Variable.chunks() for '%s': Expected one options object { start, count, maxBytes }", name);
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8(isolate, error_msg, v8::NewStringType::kNormal).ToLocalChecked()));
+        return;
+    }
+    if (obj->type < NC_BYTE || obj->type > NC_UINT64)
+    {
+        snprintf(error_msg, sizeof(error_msg),
+                 "Variable.chunks() for '%s': Variable type %d not supported for read operations", name, obj->type);
+        isolate->ThrowException(v8::Exception::TypeError(
+            v8::String::NewFromUtf8(isolate, error_msg, v8::NewStringType::kNormal).ToLocalChecked()));
+        return;
+    }
+    v8::Local<v8::Object> options = args.Length() == 1 ? args[0].As<v8::Object>() : v8::Object::New(isolate);
+
+    std::vector<size_t> start;
+    std::vector<size_t> count;
+    if (!obj->get_hyperslab(isolate, options, "chunks", start, count))
+        return;
+    size_t max_bytes = default_block_bytes;
+    v8::Local<v8::Value> max_value =
+        options->Get(context, v8::String::NewFromUtf8Literal(isolate, "maxBytes")).ToLocalChecked();
+    if (!max_value->IsUndefined())
+    {
+        const double requested = max_value->NumberValue(context).FromMaybe(0);
+        if (!(requested >= 1))
+        {
+            snprintf(error_msg, sizeof(error_msg), "Variable.chunks() for '%s': maxBytes must be a positive number",
+                     name);
+            isolate->ThrowException(v8::Exception::RangeError(
+                v8::String::NewFromUtf8(isolate, error_msg, v8::NewStringType::kNormal).ToLocalChecked()));
+            return;
+        }
+        max_bytes = requested < 9.0e15 ? static_cast<size_t>(requested) : std::numeric_limits<size_t>::max();
+    }
+
+    std::vector<size_t> tile = obj->io_tile(start, count, max_bytes);
+    auto *iterator = new ChunkIterator(obj->parent_id, obj->id, obj->type, obj->element_size(), std::move(start),
+                                       std::move(count), std::move(tile), std::vector<size_t>(obj->ndims, 0));
+    args.GetReturnValue().Set(iterator->handle(isolate));
+}
+
+void Variable::CreateReadStream(const v8::FunctionCallbackInfo<v8::Value> &args)
 {
     v8::Isolate *isolate = args.GetIsolate();
+    v8::Local<v8::Context> context = isolate->GetCurrentContext();
     Variable *obj = node::ObjectWrap::Unwrap<Variable>(args.Holder());
-    char name[NC_MAX_NAME + 1];
-    obj->get_name(name);
-    
-    if (args.Length() != 2 * obj->ndims)
+    const char *name = obj->name.c_str();
+    char error_msg[512];
+
+    if (args.Length() > 1 || (args.Length() == 1 && !args[0]->IsObject()))
     {
-        char error_msg[512];
         snprintf(error_msg, sizeof(error_msg),
-                "Variable.readSlice() for '%s': Wrong number of arguments. Expected %d pairs (pos,size) = %d arguments, but got %d",
-                name, obj->ndims, 2 * obj->ndims, args.Length());
+                 "Variable.createReadStream() for '%s': Expected one options object { start, count, highWaterMark }",
+                 name);
         isolate->ThrowException(v8::Exception::TypeError(
-            v8::String::NewFromUtf8(isolate, error_msg, v8::NewStringType::kNormal)
-                .ToLocalChecked()));
+            v8::String::NewFromUtf8(isolate, error_msg, v8::NewStringType::kNormal).ToLocalChecked()));
         return;
     }
-    if (obj->type < NC_BYTE || obj->type > NC_UINT)
+    if (obj->type < NC_BYTE || obj->type > NC_UINT64)
     {
-        char error_msg[256];
         snprintf(error_msg, sizeof(error_msg),
-                "Variable.readSlice() for '%s': Variable type %d not supported for read operations",
-                name, obj->type);
+                 "Variable.createReadStream() for '%s': Variable type %d not supported for read operations", name,
+                 obj->type);
         isolate->ThrowException(v8::Exception::TypeError(
-            v8::String::NewFromUtf8(isolate, error_msg, v8::NewStringType::kNormal)
-                .ToLocalChecked()));
+            v8::String::NewFromUtf8(isolate, error_msg, v8::NewStringType::kNormal).ToLocalChecked()));
         return;
     }
+    v8::Local<v8::Object> options = args.Length() == 1 ? args[0].As<v8::Object>() : v8::Object::New(isolate);
 
-    size_t *pos = new size_t[obj->ndims];
-    size_t *size = new size_t[obj->ndims];
-    size_t total_size = 1;
-    for (int i = 0; i < obj->ndims; i++)
-    {
-        pos[i] = static_cast<size_t>(args[2 * i]->IntegerValue(isolate->GetCurrentContext()).ToChecked());
-        size_t s = static_cast<size_t>(args[2 * i + 1]->IntegerValue(isolate->GetCurrentContext()).ToChecked());
-        size[i] = s;
-        total_size *= s;
-    }
-    v8::Local<v8::ArrayBuffer> buffer = v8::ArrayBuffer::New(isolate, total_size * type_sizes[obj->type]);
-    int retval = nc_get_vara(obj->parent_id, obj->id, pos, size, buffer->GetBackingStore()->Data());
-    if (retval != NC_NOERR)
-    {
-        throw_netcdf_error(isolate, retval);
-        delete[] pos;
-        delete[] size;
+    std::vector<size_t> start;
+    std::vector<size_t> count;
+    if (!obj->get_hyperslab(isolate, options, "createReadStream", start, count))
         return;
-    }
-    v8::Local<v8::Object> result;
-
-    switch (obj->type)
+    size_t high_water_mark = default_block_bytes;
+    v8::Local<v8::Value> mark_value =
+        options->Get(context, v8::String::NewFromUtf8Literal(isolate, "highWaterMark")).ToLocalChecked();
+    if (!mark_value->IsUndefined())
     {
-    case NC_BYTE:
-    case NC_CHAR:
-        result = v8::Int8Array::New(buffer, 0, total_size);
-        break;
-    case NC_SHORT:
-        result = v8::Int16Array::New(buffer, 0, total_size);
-        break;
-    case NC_INT:
-        result = v8::Int32Array::New(buffer, 0, total_size);
-        break;
-    case NC_FLOAT:
-        result = v8::Float32Array::New(buffer, 0, total_size);
-        break;
-    case NC_DOUBLE:
-        result = v8::Float64Array::New(buffer, 0, total_size);
-        break;
-    case NC_UBYTE:
-        result = v8::Uint8Array::New(buffer, 0, total_size);
-        break;
-    case NC_USHORT:
-        result = v8::Uint16Array::New(buffer, 0, total_size);
-        break;
-    case NC_UINT:
-        result = v8::Uint32Array::New(buffer, 0, total_size);
-        break;
-    default:
-        char error_msg[256];
-        snprintf(error_msg, sizeof(error_msg),
-                "Variable.readSlice() for '%s': Variable type %d (%s) not supported for creating typed array result",
-                name, obj->type, type_names[obj->type]);
-        isolate->ThrowException(v8::Exception::TypeError(
-            v8::String::NewFromUtf8(isolate, error_msg, v8::NewStringType::kNormal)
-                .ToLocalChecked()));
-        delete[] pos;
-        delete[] size;
-        return;
+        const double requested = mark_value->NumberValue(context).FromMaybe(0);
+        if (!(requested >= 1))
+        {
+            snprintf(error_msg, sizeof(error_msg),
+                     "Variable.createReadStream() for '%s': highWaterMark must be a positive number", name);
+            isolate->ThrowException(v8::Exception::RangeError(
+                v8::String::NewFromUtf8(isolate, error_msg, v8::NewStringType::kNormal).ToLocalChecked()));
+            return;
+        }
+        high_water_mark = requested < 9.0e15 ? static_cast<size_t>(requested) : std::numeric_limits<size_t>::max();
     }
-    args.GetReturnValue().Set(result);
-    delete[] pos;
-    delete[] size;
+
+    std::vector<size_t> origin;
+    std::vector<size_t> tile = obj->stream_tile(start, count, high_water_mark, origin);
+    auto *iterator = new ChunkIterator(obj->parent_id, obj->id, obj->type, obj->element_size(), std::move(start),
+                                       std::move(count), std::move(tile), std::move(origin));
+    v8::Local<v8::Object> stream;
+    if (iterator->make_stream(isolate, high_water_mark).ToLocal(&stream))
+        args.GetReturnValue().Set(stream);
 }
 
-void Variable::ReadStridedSlice(const v8::FunctionCallbackInfo<v8::Value> &args)
+void Variable::ReadSliceAsync(const v8::FunctionCallbackInfo<v8::Value> &args)
+{
+    QueueSlice(args, "readSliceAsync", false, false);
+}
+
+void Variable::ReadStridedSliceAsync(const v8::FunctionCallbackInfo<v8::Value> &args)
+{
+    QueueSlice(args, "readStridedSliceAsync", true, false);
+}
+
+void Variable::WriteSliceAsync(const v8::FunctionCallbackInfo<v8::Value> &args)
+{
+    QueueSlice(args, "writeSliceAsync", false, true);
+}
+
+void Variable::WriteStridedSliceAsync(const v8::FunctionCallbackInfo<v8::Value> &args)
+{
+    QueueSlice(args, "writeStridedSliceAsync", true, true);
+}
+
+void Variable::QueueSlice(const v8::FunctionCallbackInfo<v8::Value> &args, const char *method, bool strided,
+                          bool write)
 {
     v8::Isolate *isolate = args.GetIsolate();
+    v8::Local<v8::Context> context = isolate->GetCurrentContext();
     Variable *obj = node::ObjectWrap::Unwrap<Variable>(args.Holder());
-    char name[NC_MAX_NAME + 1];
-    obj->get_name(name);
-    
-    if (args.Length() != 3 * obj->ndims)
+    const char *name = obj->name.c_str();
+
+    const int arity = strided ? 3 : 2;
+    const int expected = arity * obj->ndims + (write ? 1 : 0);
+    if (args.Length() != expected)
     {
         char error_msg[512];
         snprintf(error_msg, sizeof(error_msg),
-                "Variable.readStridedSlice() for '%s': Wrong number of arguments. Expected %d triplets (pos,size,stride) = %d arguments, but got %d",
-                name, obj->ndims, 3 * obj->ndims, args.Length());
+                 "Variable.%s() for '%s': Wrong number of arguments. Expected %d %s%s = %d arguments, but got %d",
+                 method, name, obj->ndims, strided ? "triplets (pos,size,stride)" : "pairs (pos,size)",
+                 write ? " + 1 (array)" : "", expected, args.Length());
         isolate->ThrowException(v8::Exception::TypeError(
-            v8::String::NewFromUtf8(isolate, error_msg, v8::NewStringType::kNormal)
-                .ToLocalChecked()));
+            v8::String::NewFromUtf8(isolate, error_msg, v8::NewStringType::kNormal).ToLocalChecked()));
         return;
     }
-    if (obj->type < NC_BYTE || obj->type > NC_UINT)
+    if (obj->type < NC_BYTE || obj->type > NC_UINT64)
     {
         char error_msg[256];
-        snprintf(error_msg, sizeof(error_msg),
-                "Variable.readStridedSlice() for '%s': Variable type %d not supported for read operations",
-                name, obj->type);
+        snprintf(error_msg, sizeof(error_msg), "Variable.%s() for '%s': Variable type %d not supported for %s operations",
+                 method, name, obj->type, write ? "write" : "read");
         isolate->ThrowException(v8::Exception::TypeError(
-            v8::String::NewFromUtf8(isolate, error_msg, v8::NewStringType::kNormal)
-                .ToLocalChecked()));
+            v8::String::NewFromUtf8(isolate, error_msg, v8::NewStringType::kNormal).ToLocalChecked()));
         return;
     }
 
-    size_t *pos = new size_t[obj->ndims];
-    size_t *size = new size_t[obj->ndims];
-    ptrdiff_t *stride = new ptrdiff_t[obj->ndims];
-    size_t total_size = 1;
+    auto work = std::make_shared<SliceWork>();
+    work->isolate = isolate;
+    work->parent_id = obj->parent_id;
+    work->id = obj->id;
+    work->type = obj->type;
+    work->write = write;
+    work->pos.resize(obj->ndims);
+    work->size.resize(obj->ndims);
+    if (strided)
+        work->stride.resize(obj->ndims);
+    work->length = 1;
     for (int i = 0; i < obj->ndims; i++)
     {
-        pos[i] = static_cast<size_t>(args[3 * i]->IntegerValue(isolate->GetCurrentContext()).ToChecked());
-        size_t s = static_cast<size_t>(args[3 * i + 1]->IntegerValue(isolate->GetCurrentContext()).ToChecked());
-        size[i] = s;
-        total_size *= s;
-        stride[i] = static_cast<ptrdiff_t>(args[3 * i + 2]->IntegerValue(isolate->GetCurrentContext()).ToChecked());
+        work->pos[i] = static_cast<size_t>(args[arity * i]->IntegerValue(context).ToChecked());
+        work->size[i] = static_cast<size_t>(args[arity * i + 1]->IntegerValue(context).ToChecked());
+        if (strided)
+            work->stride[i] = static_cast<ptrdiff_t>(args[arity * i + 2]->IntegerValue(context).ToChecked());
+        work->length *= work->size[i];
     }
-    v8::Local<v8::ArrayBuffer> buffer = v8::ArrayBuffer::New(isolate, total_size * type_sizes[obj->type]);
-    int retval = nc_get_vars(obj->parent_id, obj->id, pos, size, stride, buffer->GetBackingStore()->Data());
-    if (retval != NC_NOERR)
+
+    if (write)
     {
-        throw_netcdf_error(isolate, retval);
-        delete[] pos;
-        delete[] size;
-        delete[] stride;
-        return;
+        if (!args[expected - 1]->IsTypedArray())
+        {
+            char error_msg[256];
+            snprintf(error_msg, sizeof(error_msg), "Variable.%s() for '%s': Last argument must be a typed array, but got %s",
+                     method, name, *v8::String::Utf8Value(isolate, args[expected - 1]->TypeOf(isolate)));
+            isolate->ThrowException(v8::Exception::TypeError(
+                v8::String::NewFromUtf8(isolate, error_msg, v8::NewStringType::kNormal).ToLocalChecked()));
+            return;
+        }
+        v8::Local<v8::TypedArray> val = v8::Local<v8::TypedArray>::Cast(args[expected - 1]);
+        if (val->Length() != work->length)
+        {
+            char error_msg[512];
+            snprintf(error_msg, sizeof(error_msg),
+                     "Variable.%s() for '%s': Array size mismatch. Expected %zu elements (product of sizes), but got %zu",
+                     method, name, work->length, val->Length());
+            isolate->ThrowException(v8::Exception::TypeError(
+                v8::String::NewFromUtf8(isolate, error_msg, v8::NewStringType::kNormal).ToLocalChecked()));
+            return;
+        }
+        const char *expected_type_name = nullptr;
+        if (!is_matching_array(obj->type, val, expected_type_name))
+        {
+            v8::String::Utf8Value actual_type(isolate, val->GetConstructorName());
+            char error_msg[512];
+            snprintf(error_msg, sizeof(error_msg),
+                     "Variable.%s() for '%s': Array type mismatch. Variable type is %s, expected %s array, but got %s",
+                     method, name, type_names[obj->type], expected_type_name, *actual_type);
+            isolate->ThrowException(v8::Exception::TypeError(
+                v8::String::NewFromUtf8(isolate, error_msg, v8::NewStringType::kNormal).ToLocalChecked()));
+            return;
+        }
+        work->store = val->Buffer()->GetBackingStore();
+        work->byte_offset = val->ByteOffset();
+    }
+    else
+    {
+        work->store = v8::ArrayBuffer::NewBackingStore(isolate, work->length * type_sizes[obj->type]);
     }
-    v8::Local<v8::Object> result;
 
-    switch (obj->type)
+    v8::Local<v8::Promise::Resolver> resolver = v8::Promise::Resolver::New(context).ToLocalChecked();
+    work->resolver.Reset(isolate, resolver);
+    work->holder.Reset(isolate, args.Holder());
+    args.GetReturnValue().Set(resolver->GetPromise());
+
+    // Counted until the completion has run, so the file cannot be closed under the I/O thread
+    if (!AsyncIO::begin(obj->parent_id, AsyncIO::session(obj->parent_id)))
     {
-    case NC_BYTE:
-    case NC_CHAR:
-        result = v8::Int8Array::New(buffer, 0, total_size);
-        break;
-    case NC_SHORT:
-        result = v8::Int16Array::New(buffer, 0, total_size);
-        break;
-    case NC_INT:
-        result = v8::Int32Array::New(buffer, 0, total_size);
-        break;
-    case NC_FLOAT:
-        result = v8::Float32Array::New(buffer, 0, total_size);
-        break;
-    case NC_DOUBLE:
-        result = v8::Float64Array::New(buffer, 0, total_size);
-        break;
-    case NC_UBYTE:
-        result = v8::Uint8Array::New(buffer, 0, total_size);
-        break;
-    case NC_USHORT:
-        result = v8::Uint16Array::New(buffer, 0, total_size);
-        break;
-    case NC_UINT:
-        result = v8::Uint32Array::New(buffer, 0, total_size);
-        break;
+        (void)resolver->Reject(context, netcdf_error(isolate, NC_EBADID));
+        return;
     }
-    args.GetReturnValue().Set(result);
-    delete[] pos;
-    delete[] size;
-    delete[] stride;
+    AsyncIO::queue(isolate, [work] { execute_slice(*work); }, [work] {
+        v8::Isolate *isolate = work->isolate;
+        v8::HandleScope scope(isolate);
+        v8::Local<v8::Object> holder = work->holder.Get(isolate);
+        v8::Local<v8::Context> context = holder->GetCreationContextChecked();
+        v8::Context::Scope context_scope(context);
+        node::CallbackScope callback_scope(isolate, holder, {0, 0});
+        AsyncIO::end(work->parent_id);
+        v8::Local<v8::Promise::Resolver> resolver = work->resolver.Get(isolate);
+        if (work->retval != NC_NOERR)
+        {
+            (void)resolver->Reject(context, netcdf_error(isolate, work->retval));
+            return;
+        }
+        if (work->write)
+        {
+            (void)resolver->Resolve(context, v8::Undefined(isolate));
+            return;
+        }
+        v8::Local<v8::ArrayBuffer> buffer = v8::ArrayBuffer::New(isolate, work->store);
+        (void)resolver->Resolve(context, make_typed_array(work->type, buffer, 0, work->length));
+    });
 }
 
 void Variable::AddAttribute(const v8::FunctionCallbackInfo<v8::Value> &args)
 {
     v8::Isolate *isolate = args.GetIsolate();
     Variable *obj = node::ObjectWrap::Unwrap<Variable>(args.Holder());
-    char var_name[NC_MAX_NAME + 1];
-    obj->get_name(var_name);
+    const char *var_name = obj->name.c_str();
     
     if (args.Length() < 3)
     {
@@ -752,7 +2839,7 @@ void Variable::AddAttribute(const v8::FunctionCallbackInfo<v8::Value> &args)
             args[0]);
         char error_msg[512];
         snprintf(error_msg, sizeof(error_msg),
-                "Variable.addAttribute() for '%s': Unknown attribute type '%s' for attribute '%s'. Valid types are: byte, char, short, int, float, double, ubyte, ushort, uint",
+                "Variable.addAttribute() for '%s': Unknown attribute type '%s' for attribute '%s'. Valid types are: byte, char, short, int, float, double, ubyte, ushort, uint, int64, uint64",
                 var_name, type_str.c_str(), attr_name.c_str());
         isolate->ThrowException(v8::Exception::TypeError(
             v8::String::NewFromUtf8(isolate, error_msg, v8::NewStringType::kNormal).ToLocalChecked()));
@@ -765,6 +2852,9 @@ void Variable::AddAttribute(const v8::FunctionCallbackInfo<v8::Value> &args)
                                        args[0]),
                                    obj->id, obj->parent_id, type);
     res->set_value(args[2]);
+    WrapperCache::set(isolate, WrapperCache::Kind::Attribute, obj->parent_id, obj->id,
+                      *v8::String::Utf8Value(isolate, args[0]), res->handle());
+    WrapperCache::erase(WrapperCache::Kind::Attributes, obj->parent_id, obj->id);
     args.GetReturnValue().Set(res->handle());
 }
 
@@ -779,22 +2869,18 @@ void Variable::GetDimensions(v8::Local<v8::String> property, const v8::PropertyC
 {
     v8::Isolate *isolate = info.GetIsolate();
     Variable *obj = node::ObjectWrap::Unwrap<Variable>(info.Holder());
-    int *dim_ids = new int[obj->ndims];
-    int retval = nc_inq_vardimid(obj->parent_id, obj->id, dim_ids);
-    if (retval != NC_NOERR)
-    {
-        throw_netcdf_error(isolate, retval);
-        delete[] dim_ids;
-        return;
-    }
     v8::Local<v8::Array> result = v8::Array::New(isolate);
     for (int i = 0; i < obj->ndims; i++)
     {
-        Dimension *d = new Dimension(dim_ids[i], obj->parent_id);
-        result->Set(isolate->GetCurrentContext(), i, d->handle());
+        const int dimid = obj->dimids[i];
+        result->Set(isolate->GetCurrentContext(), i,
+                    WrapperCache::lookup(isolate, WrapperCache::Kind::Dimension, obj->parent_id, dimid, {}, [&] {
+                        // Only a miss reaches the library, so cache hits never wait for the I/O thread
+                        const std::lock_guard<std::recursive_mutex> lock(netcdf_mutex());
+                        return (new Dimension(dimid, obj->parent_id))->handle();
+                    }));
     }
     info.GetReturnValue().Set(result);
-    delete[] dim_ids;
 }
 
 void Variable::GetAttributes(v8::Local<v8::String> property, const v8::PropertyCallbackInfo<v8::Value> &info)
@@ -802,6 +2888,14 @@ void Variable::GetAttributes(v8::Local<v8::String> property, const v8::PropertyC
     v8::Isolate *isolate = info.GetIsolate();
     v8::Local<v8::Context> context = isolate->GetCurrentContext();
     Variable *obj = node::ObjectWrap::Unwrap<Variable>(info.Holder());
+    if (v8::Local<v8::Object> cached = WrapperCache::get(isolate, WrapperCache::Kind::Attributes, obj->parent_id, obj->id);
+        !cached.IsEmpty())
+    {
+        info.GetReturnValue().Set(cached);
+        return;
+    }
+    // Only a miss reaches the library, so cache hits never wait for the I/O thread
+    const std::lock_guard<std::recursive_mutex> lock(netcdf_mutex());
     int natts;
     int retval = nc_inq_varnatts(obj->parent_id, obj->id, &natts);
     if (retval != NC_NOERR)
@@ -819,10 +2913,13 @@ void Variable::GetAttributes(v8::Local<v8::String> property, const v8::PropertyC
             throw_netcdf_error(isolate, retval);
             return;
         }
-        Attribute *a = new Attribute(name, obj->id, obj->parent_id);
+        v8::Local<v8::Object> handle =
+            WrapperCache::lookup(isolate, WrapperCache::Kind::Attribute, obj->parent_id, obj->id, name,
+                                 [&] { return (new Attribute(name, obj->id, obj->parent_id))->handle(); });
         (void)result->CreateDataProperty(context,
-                    v8::String::NewFromUtf8(isolate, name, v8::NewStringType::kInternalized).ToLocalChecked(), a->handle());
+                    v8::String::NewFromUtf8(isolate, name, v8::NewStringType::kInternalized).ToLocalChecked(), handle);
     }
+    WrapperCache::set(isolate, WrapperCache::Kind::Attributes, obj->parent_id, obj->id, {}, result);
     info.GetReturnValue().Set(result);
 }
 
@@ -830,25 +2927,20 @@ void Variable::GetType(v8::Local<v8::String> property, const v8::PropertyCallbac
 {
     v8::Isolate *isolate = info.GetIsolate();
     Variable *obj = node::ObjectWrap::Unwrap<Variable>(info.Holder());
-    const char *res;
-    if (obj->type < NC_BYTE || obj->type > NC_UINT)
-    {
-        res = "Variable type not supported yet";
-    }
-    else
-    {
-        res = type_names[obj->type];
-    }
-    info.GetReturnValue().Set(v8::String::NewFromUtf8(isolate, res, v8::NewStringType::kNormal).ToLocalChecked());
+    // Only the names of user-defined types are looked up in the library
+    std::unique_lock<std::recursive_mutex> lock(netcdf_mutex(), std::defer_lock);
+    if (obj->type > NC_STRING)
+        lock.lock();
+    info.GetReturnValue().Set(
+        v8::String::NewFromUtf8(isolate, obj->type_name().c_str(), v8::NewStringType::kNormal).ToLocalChecked());
 }
 
 void Variable::GetName(v8::Local<v8::String> property, const v8::PropertyCallbackInfo<v8::Value> &info)
 {
     v8::Isolate *isolate = info.GetIsolate();
     Variable *obj = node::ObjectWrap::Unwrap<Variable>(info.Holder());
-    char name[NC_MAX_NAME + 1];
-    if (obj->get_name(name))
-        info.GetReturnValue().Set(v8::String::NewFromUtf8(isolate, name, v8::NewStringType::kNormal).ToLocalChecked());
+    info.GetReturnValue().Set(
+        v8::String::NewFromUtf8(isolate, obj->name.c_str(), v8::NewStringType::kNormal).ToLocalChecked());
 }
 
 void Variable::SetName(v8::Local<v8::String> property, v8::Local<v8::Value> val,
@@ -867,6 +2959,8 @@ void Variable::SetName(v8::Local<v8::String> property, v8::Local<v8::Value> val,
         throw_netcdf_error(isolate, retval);
         return;
     }
+    obj->name = *new_name_;
+    WrapperCache::erase(WrapperCache::Kind::Variables, obj->parent_id, 0);
 }
 
 void Variable::GetEndianness(v8::Local<v8::String> property, const v8::PropertyCallbackInfo<v8::Value> &info)
@@ -990,15 +3084,8 @@ void Variable::GetChunkMode(v8::Local<v8::String> property, const v8::PropertyCa
 {
     v8::Isolate *isolate = info.GetIsolate();
     Variable *obj = node::ObjectWrap::Unwrap<Variable>(info.Holder());
-    int v;
-    int retval = nc_inq_var_chunking(obj->parent_id, obj->id, &v, NULL);
-    if (retval != NC_NOERR)
-    {
-        throw_netcdf_error(isolate, retval);
-        return;
-    }
     const char *res;
-    switch (v)
+    switch (obj->storage)
     {
     case NC_CONTIGUOUS:
         res = "contiguous";
@@ -1034,44 +3121,22 @@ void Variable::SetChunkMode(v8::Local<v8::String> property, v8::Local<v8::Value>
             v8::String::NewFromUtf8(isolate, "Unknown value", v8::NewStringType::kNormal).ToLocalChecked()));
         return;
     }
-    int len;
-    int retval = nc_inq_varndims(obj->parent_id, obj->id, &len);
-    if (retval != NC_NOERR)
-    {
-        throw_netcdf_error(isolate, retval);
-        return;
-    }
-    size_t *sizes = new size_t[len];
-    retval = nc_inq_var_chunking(obj->parent_id, obj->id, NULL, sizes);
-    if (retval != NC_NOERR)
-    {
-        throw_netcdf_error(isolate, retval);
-        delete[] sizes;
-        return;
-    }
-    retval = nc_def_var_chunking(obj->parent_id, obj->id, v, sizes);
+    int retval = nc_def_var_chunking(obj->parent_id, obj->id, v, obj->chunk_sizes.data());
+    if (retval == NC_NOERR)
+        retval = obj->load_chunking();
     if (retval != NC_NOERR)
         throw_netcdf_error(isolate, retval);
-    delete[] sizes;
 }
 
 void Variable::GetChunkSizes(v8::Local<v8::String> property, const v8::PropertyCallbackInfo<v8::Value> &info)
 {
     v8::Isolate *isolate = info.GetIsolate();
     Variable *obj = node::ObjectWrap::Unwrap<Variable>(info.Holder());
-    size_t *sizes = new size_t[obj->ndims];
-    int retval = nc_inq_var_chunking(obj->parent_id, obj->id, NULL, sizes);
-    if (retval != NC_NOERR)
-    {
-        throw_netcdf_error(isolate, retval);
-        delete[] sizes;
-        return;
-    }
     v8::Local<v8::Array> result = v8::Array::New(isolate);
     for (int i = 0; i < obj->ndims; i++)
-        result->Set(isolate->GetCurrentContext(), i, v8::Integer::New(isolate, i));
+        result->Set(isolate->GetCurrentContext(), i,
+                    v8::Number::New(isolate, static_cast<double>(obj->chunk_sizes[i])));
     info.GetReturnValue().Set(result);
-    delete[] sizes;
 }
 
 void Variable::SetChunkSizes(v8::Local<v8::String> property, v8::Local<v8::Value> val,
@@ -1097,23 +3162,115 @@ void Variable::SetChunkSizes(v8::Local<v8::String> property, v8::Local<v8::Value
             v8::String::NewFromUtf8(isolate, "Wrong array size", v8::NewStringType::kNormal).ToLocalChecked()));
         return;
     }
-    int v;
-    int retval = nc_inq_var_chunking(obj->parent_id, obj->id, &v, NULL);
-    if (retval != NC_NOERR)
-    {
-        throw_netcdf_error(isolate, retval);
-        return;
-    }
-    size_t *sizes = new size_t[obj->ndims];
+    std::vector<size_t> sizes(obj->ndims);
     for (int i = 0; i < obj->ndims; i++)
         sizes[i] = array->Get(isolate->GetCurrentContext(), i)
                        .ToLocalChecked()
                        ->Uint32Value(isolate->GetCurrentContext())
                        .ToChecked();
-    retval = nc_def_var_chunking(obj->parent_id, obj->id, v, sizes);
+    int retval = nc_def_var_chunking(obj->parent_id, obj->id, obj->storage, sizes.data());
+    if (retval == NC_NOERR)
+        retval = obj->load_chunking();
     if (retval != NC_NOERR)
         throw_netcdf_error(isolate, retval);
-    delete[] sizes;
+}
+
+void Variable::GetChunkCache(v8::Local<v8::String> property, const v8::PropertyCallbackInfo<v8::Value> &info)
+{
+    v8::Isolate *isolate = info.GetIsolate();
+    v8::Local<v8::Context> context = isolate->GetCurrentContext();
+    Variable *obj = node::ObjectWrap::Unwrap<Variable>(info.Holder());
+    size_t size = 0;
+    size_t nelems = 0;
+    float preemption = 0;
+    if (const int retval = nc_get_var_chunk_cache(obj->parent_id, obj->id, &size, &nelems, &preemption);
+        retval != NC_NOERR)
+    {
+        throw_netcdf_error(isolate, retval);
+        return;
+    }
+    v8::Local<v8::Object> result = v8::Object::New(isolate);
+    (void)result->CreateDataProperty(context, v8::String::NewFromUtf8Literal(isolate, "size"),
+                                     v8::Number::New(isolate, static_cast<double>(size)));
+    (void)result->CreateDataProperty(context, v8::String::NewFromUtf8Literal(isolate, "nelems"),
+                                     v8::Number::New(isolate, static_cast<double>(nelems)));
+    (void)result->CreateDataProperty(context, v8::String::NewFromUtf8Literal(isolate, "preemption"),
+                                     v8::Number::New(isolate, preemption));
+    info.GetReturnValue().Set(result);
+}
+
+void Variable::SetChunkCache(v8::Local<v8::String> property, v8::Local<v8::Value> val,
+                             const v8::PropertyCallbackInfo<void> &info)
+{
+    v8::Isolate *isolate = info.GetIsolate();
+    v8::Local<v8::Context> context = isolate->GetCurrentContext();
+    Variable *obj = node::ObjectWrap::Unwrap<Variable>(info.Holder());
+    if (!val->IsObject())
+    {
+        isolate->ThrowException(v8::Exception::TypeError(v8::String::NewFromUtf8Literal(
+            isolate, "Expecting an object { size, nelems, preemption } or { access, maxSize }")));
+        return;
+    }
+    v8::Local<v8::Object> options = val.As<v8::Object>();
+    size_t size = 0;
+    size_t nelems = 0;
+    float preemption = 0;
+    if (const int retval = nc_get_var_chunk_cache(obj->parent_id, obj->id, &size, &nelems, &preemption);
+        retval != NC_NOERR)
+    {
+        throw_netcdf_error(isolate, retval);
+        return;
+    }
+
+    if (options->Has(context, v8::String::NewFromUtf8Literal(isolate, "access")).FromMaybe(false))
+    {
+        std::vector<size_t> access;
+        if (!obj->get_index_array(isolate, options, "access", "chunkCache", access))
+            return;
+        if (access.size() != static_cast<size_t>(obj->ndims) || obj->storage != NC_CHUNKED)
+        {
+            isolate->ThrowException(v8::Exception::TypeError(v8::String::NewFromUtf8Literal(
+                isolate, "chunkCache.access needs one extent per dimension of a chunked variable")));
+            return;
+        }
+        if (!get_chunk_cache_options(isolate, options, size, nelems, preemption))
+            return;
+        size_t max_size = default_auto_cache_bytes;
+        v8::Local<v8::Value> max_value =
+            options->Get(context, v8::String::NewFromUtf8Literal(isolate, "maxSize")).ToLocalChecked();
+        if (!max_value->IsUndefined())
+        {
+            const double requested = max_value->NumberValue(context).FromMaybe(-1);
+            if (!(requested >= 0))
+            {
+                isolate->ThrowException(v8::Exception::RangeError(
+                    v8::String::NewFromUtf8Literal(isolate, "chunkCache.maxSize must be a non-negative number")));
+                return;
+            }
+            max_size = requested < 9.0e15 ? static_cast<size_t>(requested) : std::numeric_limits<size_t>::max();
+        }
+
+        // Hold every chunk one read of the declared extent can touch, so repeated reads
+        // (e.g. neighbouring point time series) find them decompressed
+        const std::vector<size_t> &shape = obj->current_lengths();
+        size_t touched = 1;
+        for (int d = 0; d < obj->ndims; d++)
+        {
+            const size_t chunk = obj->chunk_sizes[d];
+            const size_t grid = std::max<size_t>((shape[d] + chunk - 1) / chunk, 1);
+            const size_t span = access[d] == 0 ? 1 : (access[d] - 1 + chunk - 1) / chunk + 1;
+            touched *= std::min(grid, span);
+        }
+        const size_t chunk_bytes = obj->element_size() * box_size(obj->chunk_sizes);
+        size = std::max(std::min(touched * chunk_bytes, max_size), chunk_bytes);
+        nelems = next_prime(std::max<size_t>(size / chunk_bytes * 100, 521));
+    }
+    else if (!get_chunk_cache_options(isolate, options, size, nelems, preemption))
+        return;
+
+    if (const int retval = nc_set_var_chunk_cache(obj->parent_id, obj->id, size, nelems, preemption);
+        retval != NC_NOERR)
+        throw_netcdf_error(isolate, retval);
 }
 
 void Variable::GetFillMode(v8::Local<v8::String> property, const v8::PropertyCallbackInfo<v8::Value> &info)
@@ -1146,7 +3303,7 @@ void Variable::SetFillMode(v8::Local<v8::String> property, v8::Local<v8::Value>
 #else
     int v = val->BooleanValue() ? 1 : 0;
 #endif
-    if (obj->type < NC_BYTE || obj->type > NC_UINT)
+    if (obj->type < NC_BYTE || obj->type > NC_UINT64)
     {
         isolate->ThrowException(v8::Exception::TypeError(
             v8::String::NewFromUtf8(isolate, "Variable type not supported yet", v8::NewStringType::kNormal)
@@ -1164,6 +3321,7 @@ void Variable::SetFillMode(v8::Local<v8::String> property, v8::Local<v8::Value>
     retval = nc_def_var_fill(obj->parent_id, obj->id, v, value);
     if (retval != NC_NOERR)
         throw_netcdf_error(isolate, retval);
+    obj->missing_loaded = false;
     delete[] value;
 }
 
@@ -1230,6 +3388,18 @@ void Variable::GetFillValue(v8::Local<v8::String> property, const v8::PropertyCa
         result = v8::Integer::New(isolate, v);
     }
     break;
+    case NC_INT64: {
+        int64_t v;
+        retval = nc_inq_var_fill(obj->parent_id, obj->id, NULL, &v);
+        result = v8::BigInt::New(isolate, v);
+    }
+    break;
+    case NC_UINT64: {
+        uint64_t v;
+        retval = nc_inq_var_fill(obj->parent_id, obj->id, NULL, &v);
+        result = v8::BigInt::NewFromUnsigned(isolate, v);
+    }
+    break;
     default:
         isolate->ThrowException(v8::Exception::TypeError(
             v8::String::NewFromUtf8(isolate, "Variable type not supported yet", v8::NewStringType::kNormal)
@@ -1299,6 +3469,16 @@ void Variable::SetFillValue(v8::Local<v8::String> property, v8::Local<v8::Value>
         retval = nc_def_var_fill(obj->parent_id, obj->id, mode, &v);
     }
     break;
+    case NC_INT64: {
+        int64_t v = get_integer64<int64_t>(isolate, val);
+        retval = nc_def_var_fill(obj->parent_id, obj->id, mode, &v);
+    }
+    break;
+    case NC_UINT64: {
+        uint64_t v = get_integer64<uint64_t>(isolate, val);
+        retval = nc_def_var_fill(obj->parent_id, obj->id, mode, &v);
+    }
+    break;
     default:
         isolate->ThrowException(v8::Exception::TypeError(
             v8::String::NewFromUtf8(isolate, "Variable type not supported yet", v8::NewStringType::kNormal)
@@ -1307,6 +3487,7 @@ void Variable::SetFillValue(v8::Local<v8::String> property, v8::Local<v8::Value>
     }
     if (retval != NC_NOERR)
         throw_netcdf_error(isolate, retval);
+    obj->missing_loaded = false;
 }
 
 void Variable::GetCompressionShuffle(v8::Local<v8::String> property, const v8::PropertyCallbackInfo<v8::Value> &info)
@@ -1459,15 +3640,12 @@ void Variable::ToJSON(const v8::FunctionCallbackInfo<v8::Value> &args)
     
     (void)json->CreateDataProperty(context, id_str, v8::Integer::New(isolate, obj->id));
     
-    char name[NC_MAX_NAME + 1];
-    if (obj->get_name(name))
-        (void)json->CreateDataProperty(context, name_str,
-                  v8::String::NewFromUtf8(isolate, name, v8::NewStringType::kInternalized).ToLocalChecked());
+    (void)json->CreateDataProperty(context, name_str,
+              v8::String::NewFromUtf8(isolate, obj->name.c_str(), v8::NewStringType::kInternalized).ToLocalChecked());
     
     // Add type
-    const char *type_name = (obj->type < NC_BYTE || obj->type > NC_UINT) ? "unknown" : type_names[obj->type];
     (void)json->CreateDataProperty(context, type_str,
-              v8::String::NewFromUtf8(isolate, type_name, v8::NewStringType::kInternalized).ToLocalChecked());
+              v8::String::NewFromUtf8(isolate, obj->type_name().c_str(), v8::NewStringType::kInternalized).ToLocalChecked());
     
     v8::Local<v8::Value> dimensions = args.Holder()->Get(context, dimensions_str).ToLocalChecked();
     if (dimensions->IsArray())
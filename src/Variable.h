@@ -2,9 +2,13 @@
 #define NODENETCDFJS_VARIABLE_H
 
 #include <array>
+#include <map>
 #include <netcdf.h>
 #include <node.h>
 #include <node_object_wrap.h>
+#include <string>
+#include <utility>
+#include <vector>
 
 
 namespace nodenetcdfjs
@@ -27,11 +31,12 @@ class Variable : public node::ObjectWrap
     /**
      * @brief Initialize the Variable class and register it with Node.js
      * @param exports The exports object to attach the Variable constructor to
+     * @param module The addon module, used to require the stream built-in
      * 
      * This static method sets up the Variable class for use in Node.js,
      * defining its constructor and prototype methods.
      */
-    static void Init(v8::Local<v8::Object> exports);
+    static void Init(v8::Local<v8::Object> exports, v8::Local<v8::Value> module);
     
     /**
      * @brief Construct a Variable object
@@ -47,12 +52,117 @@ class Variable : public node::ObjectWrap
      * @param name Buffer to store the variable name
      * @return true if successful, false otherwise
      * 
-     * Retrieves the variable name from the NetCDF file and stores it
-     * in the provided buffer.
+     * Copies the cached variable name into the provided buffer.
      */
     [[nodiscard]] bool get_name(char *name) const noexcept;
 
+    /**
+     * @brief Get the Variable wrapped by a JavaScript value
+     * @param isolate The V8 isolate
+     * @param value The value to inspect
+     * @return The Variable, or nullptr if the value is not a Variable object
+     */
+    [[nodiscard]] static Variable *unwrap(v8::Isolate *isolate, v8::Local<v8::Value> value);
+
+    /**
+     * @brief Get the variable ID within its group
+     */
+    [[nodiscard]] int get_id() const noexcept;
+
+    /**
+     * @brief Get the ID of the group holding this variable
+     */
+    [[nodiscard]] int get_parent_id() const noexcept;
+
+    /**
+     * @brief Get the NetCDF data type of this variable
+     */
+    [[nodiscard]] nc_type get_element_type() const noexcept;
+
+    /**
+     * @brief Get the number of dimensions of this variable
+     */
+    [[nodiscard]] int get_ndims() const noexcept;
+
+    /**
+     * @brief Get the size in bytes of one element, or 0 for types without a typed array equivalent
+     */
+    [[nodiscard]] size_t element_size() const noexcept;
+
+    /**
+     * @brief Read a (strided) hyperslab into caller-owned memory
+     * @param start Starting index for each dimension
+     * @param count Number of elements for each dimension
+     * @param stride Stride for each dimension, or nullptr for a contiguous slice
+     * @param data Destination, large enough for the product of count elements
+     * @return NC_NOERR on success, the NetCDF error code otherwise
+     */
+    [[nodiscard]] int read_slice(const size_t *start, const size_t *count, const ptrdiff_t *stride,
+                                 void *data) const noexcept;
+
+    /**
+     * @brief Create the typed array view matching a NetCDF type
+     * @param type The NetCDF data type of the elements
+     * @param buffer The array buffer holding the data
+     * @param byte_offset Offset of the first element in the buffer
+     * @param length Number of elements
+     * @return The typed array, or an empty handle if the type has no typed array equivalent
+     */
+    [[nodiscard]] static v8::Local<v8::Object> make_typed_array(nc_type type, v8::Local<v8::ArrayBuffer> buffer,
+                                                                size_t byte_offset, size_t length);
+
+    /**
+     * @brief Drop cached attribute-derived state of a variable
+     * @param isolate The V8 isolate
+     * @param parent_id The parent group/file ID
+     * @param var_id The variable ID; NC_GLOBAL is ignored
+     *
+     * Called whenever an attribute is added, renamed, changed or deleted.
+     */
+    static void attributes_changed(v8::Isolate *isolate, int parent_id, int var_id);
+
+    /**
+     * @brief Write the records buffered by appendRecords() for every variable of a file
+     * @param ncid Any group ID of the file
+     * @param closing Whether the file is about to be closed; records that fail to write are dropped
+     * @return NC_NOERR on success, otherwise the first NetCDF error code
+     *
+     * Called by File.sync() and before the file is closed.
+     */
+    [[nodiscard]] static int flush_appends(int ncid, bool closing) noexcept;
+
+    /**
+     * @brief Length an unlimited dimension will have once the records buffered by appendRecords() are written
+     * @param ncid Any group ID of the file
+     * @param dimid The dimension ID
+     * @return The end of the furthest buffered record along the dimension, 0 if none is buffered
+     *
+     * Lets metadata snapshots report buffered records without writing them.
+     */
+    [[nodiscard]] static size_t buffered_length(int ncid, int dimid) noexcept;
+
   private:
+    /// How slice reads treat _FillValue and missing_value
+    enum class Mask : int
+    {
+        None,
+        NaN,
+        Bitmap
+    };
+
+    /// Conversions applied by slice reads, see get_read_options()
+    struct ReadOptions
+    {
+        /// NetCDF type of the returned elements
+        nc_type output_type{NC_NAT};
+
+        /// Whether to apply scale_factor and add_offset
+        bool unpack{false};
+
+        /// Whether missing values become NaN or are reported in a validity bitmap
+        Mask mask{Mask::None};
+    };
+
     // Delete copy and move operations for safety
     Variable(const Variable &) = delete;
     Variable &operator=(const Variable &) = delete;
@@ -69,19 +179,22 @@ class Variable : public node::ObjectWrap
     
     /**
      * @brief Read a slice of variable data
-     * @param args JavaScript function arguments (start indices, counts)
+     * @param args JavaScript function arguments (start indices, counts, optional options)
      * 
      * Reads a hyperslab of data from the variable, specified by start positions
-     * and count values for each dimension.
+     * and count values for each dimension. An options object with outputType
+     * converts the values to another numeric type while reading; unpack applies
+     * the CF scale_factor/add_offset and mask replaces missing values in the same call.
      */
     static void ReadSlice(const v8::FunctionCallbackInfo<v8::Value> &args);
     
     /**
      * @brief Read a strided slice of variable data
-     * @param args JavaScript function arguments (start indices, counts, strides)
+     * @param args JavaScript function arguments (start indices, counts, strides, optional options)
      * 
      * Reads a strided hyperslab of data from the variable, with additional
-     * stride parameters to skip elements in each dimension.
+     * stride parameters to skip elements in each dimension. Accepts the same
+     * options as ReadSlice().
      */
     static void ReadStridedSlice(const v8::FunctionCallbackInfo<v8::Value> &args);
     
@@ -109,6 +222,335 @@ class Variable : public node::ObjectWrap
      * Writes a strided hyperslab of data to the variable.
      */
     static void WriteStridedSlice(const v8::FunctionCallbackInfo<v8::Value> &args);
+
+    /**
+     * @brief Read the strings of a string or char variable in Apache Arrow's utf8 layout
+     * @param args JavaScript function arguments (start indices, counts)
+     *
+     * Returns { data, offsets }: the UTF-8 bytes of every string back to back in a Uint8Array,
+     * and an Int32Array of count + 1 offsets where string i spans offsets[i] to offsets[i + 1].
+     * For char variables the (pos,size) pairs cover every dimension but the last, which holds
+     * the characters; each row ends at its first NUL and trailing blanks are trimmed.
+     */
+    static void ReadStrings(const v8::FunctionCallbackInfo<v8::Value> &args);
+
+    /**
+     * @brief Read a slice of variable data on the I/O thread
+     * @param args JavaScript function arguments (start indices, counts)
+     *
+     * Same arguments as readSlice(), but the NetCDF read runs off the event loop.
+     * Returns a Promise resolving to the typed array. The read holds netcdf_mutex(), so
+     * synchronous calls into the library made meanwhile (uncached accessors, readSlice(),
+     * the finalizer of a collected File) wait for it; cached accessors do not.
+     */
+    static void ReadSliceAsync(const v8::FunctionCallbackInfo<v8::Value> &args);
+
+    /**
+     * @brief Read a strided slice of variable data on the I/O thread
+     * @param args JavaScript function arguments (start indices, counts, strides)
+     *
+     * Same arguments as readStridedSlice(); returns a Promise resolving to the typed array.
+     */
+    static void ReadStridedSliceAsync(const v8::FunctionCallbackInfo<v8::Value> &args);
+
+    /**
+     * @brief Write a slice of variable data on the I/O thread
+     * @param args JavaScript function arguments (start indices, counts, data)
+     *
+     * Same arguments as writeSlice(); returns a Promise resolved once the data is written.
+     * The typed array must not be modified until the Promise settles.
+     */
+    static void WriteSliceAsync(const v8::FunctionCallbackInfo<v8::Value> &args);
+
+    /**
+     * @brief Write a strided slice of variable data on the I/O thread
+     * @param args JavaScript function arguments (start indices, counts, strides, data)
+     *
+     * Same arguments as writeStridedSlice(); returns a Promise resolved once the data is written.
+     */
+    static void WriteStridedSliceAsync(const v8::FunctionCallbackInfo<v8::Value> &args);
+
+    /**
+     * @brief Read a slice of variable data into a caller-supplied typed array
+     * @param args JavaScript function arguments (start indices, counts, target, optional byte offset)
+     *
+     * Reads the hyperslab directly into the target's backing store without allocating a new buffer.
+     * Returns the target.
+     */
+    static void ReadSliceInto(const v8::FunctionCallbackInfo<v8::Value> &args);
+
+    /**
+     * @brief Read a strided slice of variable data into a caller-supplied typed array
+     * @param args JavaScript function arguments (start indices, counts, strides, target, optional byte offset)
+     *
+     * Strided counterpart of readSliceInto(). Returns the target.
+     */
+    static void ReadStridedSliceInto(const v8::FunctionCallbackInfo<v8::Value> &args);
+
+    /**
+     * @brief Parse a read options object
+     * @param isolate The V8 isolate
+     * @param value undefined, or an object with optional outputType, unpack and mask fields
+     * @param method Method name used in error messages
+     * @param options Receives the parsed options; the variable type and no unpacking by default
+     * @return true on success; otherwise a JavaScript exception has been thrown
+     *
+     * Loads the packing attributes or missing values into the cache when unpacking
+     * or masking is requested.
+     */
+    [[nodiscard]] bool get_read_options(v8::Isolate *isolate, v8::Local<v8::Value> value, const char *method,
+                                        ReadOptions &options);
+
+    /**
+     * @brief Post-process values read with get_read_options() options and wrap them for JavaScript
+     * @param isolate The V8 isolate
+     * @param options The parsed options
+     * @param buffer The array buffer holding length values of options.output_type
+     * @param length Number of values
+     * @return The typed array, or { values, validity } when a bitmap was requested;
+     *         an empty handle if the type has no typed array equivalent
+     *
+     * Missing values are masked before unpacking, since they are stored packed.
+     */
+    [[nodiscard]] v8::Local<v8::Object> make_read_result(v8::Isolate *isolate, const ReadOptions &options,
+                                                         v8::Local<v8::ArrayBuffer> buffer, size_t length) const;
+
+    /**
+     * @brief Validate the arguments of a readSliceInto call and read into the target
+     * @param args JavaScript function arguments
+     * @param method Method name used in error messages
+     * @param strided Whether arguments come in (pos, size, stride) triplets
+     */
+    static void ReadInto(const v8::FunctionCallbackInfo<v8::Value> &args, const char *method, bool strided);
+
+    /**
+     * @brief Read values at scattered points
+     * @param args JavaScript function arguments (flat npoints x ndims coordinate typed array)
+     *
+     * Points are grouped by chunk so every touched chunk is read once; values are returned
+     * in a single typed array in the order of the coordinates.
+     */
+    static void ReadPoints(const v8::FunctionCallbackInfo<v8::Value> &args);
+
+    /**
+     * @brief Write values at scattered points
+     * @param args JavaScript function arguments (flat npoints x ndims coordinate typed array, values typed array)
+     *
+     * Updates are grouped by chunk so every touched chunk is read, patched and written back once.
+     */
+    static void WritePoints(const v8::FunctionCallbackInfo<v8::Value> &args);
+
+    /**
+     * @brief Append records along the leading unlimited dimension with write-behind buffering
+     * @param args JavaScript function arguments (typed array of whole records)
+     *
+     * Records are held in memory until they complete a storage chunk along the record
+     * dimension, then written with one chunk-aligned nc_put_vara, so partially filled
+     * chunks are not rewritten and recompressed on every call. The remainder is written
+     * by flush_appends().
+     */
+    static void AppendRecords(const v8::FunctionCallbackInfo<v8::Value> &args);
+
+    /**
+     * @brief Create an object-mode stream.Writable appending each typed array written to it
+     * @param args JavaScript function arguments (none)
+     *
+     * Every write goes through the same buffering as appendRecords(); ending the stream
+     * writes the records still buffered for this variable.
+     */
+    static void CreateAppendStream(const v8::FunctionCallbackInfo<v8::Value> &args);
+
+    /**
+     * @brief write() of a stream made by CreateAppendStream(), appending one typed array
+     * @param args Chunk, encoding and callback; the variable is the function data
+     */
+    static void AppendStreamWrite(const v8::FunctionCallbackInfo<v8::Value> &args);
+
+    /**
+     * @brief final() of a stream made by CreateAppendStream(), writing the buffered records
+     * @param args Callback; the variable is the function data
+     */
+    static void AppendStreamFinal(const v8::FunctionCallbackInfo<v8::Value> &args);
+
+    /**
+     * @brief Check and buffer records for appendRecords() and append streams
+     * @param isolate The V8 isolate
+     * @param records Typed array of whole records
+     * @param method Method name used in error messages
+     * @return true on success; otherwise a JavaScript exception has been thrown
+     */
+    [[nodiscard]] bool append_records(v8::Isolate *isolate, v8::Local<v8::Value> records, const char *method);
+
+    /**
+     * @brief Write buffered records
+     * @param all Whether to write every record, or only those completing a storage chunk
+     * @return NC_NOERR on success, the NetCDF error code otherwise
+     */
+    [[nodiscard]] int flush_records(bool all) noexcept;
+
+    /**
+     * @brief Discard buffered records, e.g. after they failed to write
+     */
+    void drop_records() noexcept;
+
+    /**
+     * @brief Variables holding records buffered by appendRecords()
+     * @return The process-wide list, each entry Ref()ed until its records are written
+     */
+    [[nodiscard]] static std::vector<Variable *> &appending() noexcept;
+
+    /**
+     * @brief Record index where the next appendRecords() call of each variable starts
+     * @return The process-wide map from (group ID, variable ID) to the end of the records appended so far
+     *
+     * Kept per variable rather than read from the shared unlimited dimension, whose length
+     * also grows with the records of other variables. Entries outlive the wrappers and are
+     * dropped when the file is closed.
+     */
+    [[nodiscard]] static std::map<std::pair<int, int>, size_t> &append_cursors() noexcept;
+
+    /// Where appending along a record dimension began and how far its records reach
+    struct AppendOrigin
+    {
+        /// Length of the dimension when appending began; first appends of every variable start here
+        size_t start{0};
+
+        /// End of the furthest record written by appendRecords() along the dimension
+        size_t end{0};
+    };
+
+    /**
+     * @brief Origin of the appends along each record dimension
+     * @return The process-wide map from (file ID, dimension ID) to its AppendOrigin
+     *
+     * Every variable's first append starts at the origin, so variables appended in lockstep
+     * stay aligned whichever of them is flushed first. When nothing is appending along the
+     * dimension and it has grown past every appended record (e.g. through writeSlice()),
+     * the origin moves to its new end.
+     */
+    [[nodiscard]] static std::map<std::pair<int, int>, AppendOrigin> &append_origins() noexcept;
+
+    /**
+     * @brief Compute min/max/sum/mean/count over a hyperslab without materializing it
+     * @param args JavaScript function arguments (options object: start, count, ops, axes, unpack)
+     *
+     * The slice is read one storage chunk at a time into a scratch buffer and folded into
+     * per-output accumulators, skipping NaN and missing values. Axes listed in axes are
+     * reduced; the others remain in the result shape.
+     */
+    static void Reduce(const v8::FunctionCallbackInfo<v8::Value> &args);
+
+    /**
+     * @brief Iterate over a hyperslab in blocks aligned to the storage chunk grid
+     * @param args JavaScript function arguments (options object: start, count, maxBytes)
+     *
+     * Returns a ChunkIterator yielding { start, count, data } blocks in C order of the
+     * block grid, each read on the I/O thread while the previous one is processed.
+     */
+    static void Chunks(const v8::FunctionCallbackInfo<v8::Value> &args);
+
+    /**
+     * @brief Create a stream.Readable of the raw hyperslab bytes in C order
+     * @param args JavaScript function arguments (options object: start, count, highWaterMark)
+     *
+     * Blocks of about highWaterMark bytes are read ahead on the I/O thread and only
+     * requested while the stream wants more data.
+     */
+    static void CreateReadStream(const v8::FunctionCallbackInfo<v8::Value> &args);
+
+    /**
+     * @brief Read the start and count arrays of an options object and check them against the shape
+     * @param isolate The V8 isolate
+     * @param options The options object
+     * @param method Method name used in error messages
+     * @param start Receives the start, zeros if absent
+     * @param count Receives the count, the rest of each dimension if absent
+     * @return true on success; otherwise a JavaScript exception has been thrown
+     */
+    [[nodiscard]] bool get_hyperslab(v8::Isolate *isolate, v8::Local<v8::Object> options, const char *method,
+                                     std::vector<size_t> &start, std::vector<size_t> &count);
+
+    /**
+     * @brief Read an optional array of non-negative integers from an options object
+     * @param isolate The V8 isolate
+     * @param options The options object
+     * @param key Property name
+     * @param method Method name used in error messages
+     * @param indices Receives the values; left unchanged if the property is undefined
+     * @return true on success; otherwise a JavaScript exception has been thrown
+     */
+    [[nodiscard]] bool get_index_array(v8::Isolate *isolate, v8::Local<v8::Object> options, const char *key,
+                                       const char *method, std::vector<size_t> &indices);
+
+    /**
+     * @brief Get the natural I/O block of this variable
+     * @return The chunk sizes for chunked storage, otherwise one row of the last dimension
+     */
+    [[nodiscard]] std::vector<size_t> block_shape() noexcept;
+
+    /**
+     * @brief Get the shape of the blocks used to walk a hyperslab
+     * @param start Start of the hyperslab
+     * @param count Extent of the hyperslab
+     * @param max_bytes Size limit of one block
+     * @return A multiple of block_shape(), growing from the fastest dimension
+     *
+     * Storage chunks are never split, so a block exceeds max_bytes when a single chunk does.
+     * Rows of contiguous storage are split to fit.
+     */
+    [[nodiscard]] std::vector<size_t> io_tile(const std::vector<size_t> &start, const std::vector<size_t> &count,
+                                              size_t max_bytes) noexcept;
+
+    /**
+     * @brief Get blocks of a hyperslab that follow each other in C order
+     * @param start Start of the hyperslab
+     * @param count Extent of the hyperslab
+     * @param max_bytes Size limit of one block
+     * @param origin Receives the corner of the block grid
+     * @return Block shape: whole trailing dimensions, one split dimension, ones before it
+     */
+    [[nodiscard]] std::vector<size_t> stream_tile(const std::vector<size_t> &start, const std::vector<size_t> &count,
+                                                  size_t max_bytes, std::vector<size_t> &origin) noexcept;
+
+    /**
+     * @brief Convert a flat coordinate typed array into indices and check them against the shape
+     * @param isolate The V8 isolate
+     * @param value Int32Array, Uint32Array, BigInt64Array or BigUint64Array of npoints x ndims indices
+     * @param method Method name used in error messages
+     * @param coords Receives the indices
+     * @return true on success; otherwise a JavaScript exception has been thrown
+     */
+    [[nodiscard]] bool get_coords(v8::Isolate *isolate, v8::Local<v8::Value> value, const char *method,
+                                  std::vector<size_t> &coords);
+
+    /**
+     * @brief Order points so that points in the same block are adjacent
+     * @param coords Flat npoints x ndims indices
+     * @param block Block shape, see block_shape()
+     * @return Point indices sorted by block
+     */
+    [[nodiscard]] std::vector<size_t> sort_by_block(const std::vector<size_t> &coords,
+                                                    const std::vector<size_t> &block) const;
+
+    /**
+     * @brief Validate the arguments of an async slice call and queue the NetCDF work
+     * @param args JavaScript function arguments
+     * @param method Method name used in error messages
+     * @param strided Whether arguments come in (pos, size, stride) triplets
+     * @param write Whether the last argument is a typed array to write
+     */
+    static void QueueSlice(const v8::FunctionCallbackInfo<v8::Value> &args, const char *method, bool strided,
+                           bool write);
+
+    /**
+     * @brief Check that a typed array matches a NetCDF type
+     * @param type The NetCDF data type of the variable
+     * @param array The typed array to check
+     * @param expected_type_name Set to the name of the expected typed array class
+     * @return true if the typed array can hold values of the given type
+     */
+    [[nodiscard]] static bool is_matching_array(nc_type type, v8::Local<v8::TypedArray> array,
+                                                const char *&expected_type_name);
     
     /**
      * @brief Add a new attribute to this variable
@@ -239,6 +681,23 @@ class Variable : public node::ObjectWrap
      */
     static void SetChunkSizes(v8::Local<v8::String> property, v8::Local<v8::Value> val,
                               const v8::PropertyCallbackInfo<void> &info);
+
+    /**
+     * @brief Getter for the chunk cache property ({ size, nelems, preemption })
+     * @param property The property name being accessed
+     * @param info Callback info containing the return value
+     */
+    static void GetChunkCache(v8::Local<v8::String> property, const v8::PropertyCallbackInfo<v8::Value> &info);
+
+    /**
+     * @brief Setter for the chunk cache property
+     * @param property The property name being set
+     * @param val { size, nelems, preemption }, or { access, maxSize, preemption } to size the
+     *            cache for reads of the given per-dimension extent
+     * @param info Callback info for the setter
+     */
+    static void SetChunkCache(v8::Local<v8::String> property, v8::Local<v8::Value> val,
+                              const v8::PropertyCallbackInfo<void> &info);
     
     /**
      * @brief Getter for the fill mode property
@@ -342,15 +801,68 @@ class Variable : public node::ObjectWrap
      */
     static void ToJSON(const v8::FunctionCallbackInfo<v8::Value> &args);
 
+    /**
+     * @brief Query name, type, dimensions and chunking from the NetCDF file into the cache
+     * @return NC_NOERR on success, the NetCDF error code otherwise
+     */
+    [[nodiscard]] int load_metadata() noexcept;
+
+    /**
+     * @brief Query the storage mode and chunk sizes into the cache
+     * @return NC_NOERR on success, the NetCDF error code otherwise
+     */
+    [[nodiscard]] int load_chunking() noexcept;
+
+    /**
+     * @brief Get the current dimension lengths
+     * @return The cached lengths, with unlimited dimensions re-queried
+     *
+     * Fixed dimensions cannot change, so only unlimited dimensions cost a NetCDF call.
+     */
+    [[nodiscard]] const std::vector<size_t> &current_lengths() noexcept;
+
+    /**
+     * @brief Query the CF scale_factor and add_offset attributes into the cache
+     * @return NC_NOERR on success, the NetCDF error code otherwise
+     */
+    [[nodiscard]] int load_packing() noexcept;
+
+    /**
+     * @brief Query _FillValue (or the type's default fill) and missing_value into the cache
+     * @return NC_NOERR on success, the NetCDF error code otherwise
+     */
+    [[nodiscard]] int load_missing_values() noexcept;
+
+    /**
+     * @brief Get the name of the variable's type, atomic or user-defined
+     * @return The type name, or "unknown" if the type cannot be queried
+     */
+    [[nodiscard]] std::string type_name() const;
+
+    /**
+     * @brief Read a hyperslab of a variable of user-defined type into columns
+     * @param isolate The V8 isolate
+     * @param pos Start of the hyperslab for each dimension
+     * @param size Extent of the hyperslab for each dimension
+     * @param total_size Number of elements in the hyperslab
+     * @return The columns decoded by UserType::decode(), or an empty handle after throwing
+     */
+    [[nodiscard]] v8::MaybeLocal<v8::Value> read_user_type(v8::Isolate *isolate, const size_t *pos,
+                                                          const size_t *size, size_t total_size);
+
     /// Persistent reference to the JavaScript constructor function
     static v8::Persistent<v8::Function> constructor;
 
-    /// Size in bytes for each NetCDF data type
-    static constexpr std::array<unsigned char, 11> type_sizes = {1, 1, 2, 4, 4, 8, 1, 2, 4, 8, 0};
+    /// Persistent reference to stream.Writable
+    static v8::Persistent<v8::Function> writable;
+
+    /// Size in bytes for each NetCDF data type, indexed by nc_type (NC_NAT .. NC_UINT64)
+    static constexpr std::array<unsigned char, 12> type_sizes = {0, 1, 1, 2, 4, 4, 8, 1, 2, 4, 8, 8};
 
-    /// String names for each NetCDF data type
-    static constexpr std::array<const char *, 11> type_names = {"byte",  "char",   "short", "int",   "float", "double",
-                                                                "ubyte", "ushort", "uint",  "int64", "string"};
+    /// String names for each NetCDF data type, indexed by nc_type (NC_NAT .. NC_STRING)
+    static constexpr std::array<const char *, 13> type_names = {"nat",   "byte",   "char", "short", "int",
+                                                                "float", "double", "ubyte", "ushort", "uint",
+                                                                "int64", "uint64", "string"};
 
     /// The variable ID in the NetCDF file
     int id{-1};
@@ -363,6 +875,51 @@ class Variable : public node::ObjectWrap
     
     /// Number of dimensions for this variable
     int ndims{0};
+
+    /// Cached variable name, updated on rename
+    std::string name;
+
+    /// Cached dimension IDs
+    std::vector<int> dimids;
+
+    /// Cached dimension lengths, see current_lengths()
+    std::vector<size_t> lengths;
+
+    /// Whether each dimension is unlimited
+    std::vector<bool> unlimited;
+
+    /// Cached storage mode (NC_CONTIGUOUS, NC_CHUNKED, ...)
+    int storage{NC_CONTIGUOUS};
+
+    /// Cached chunk sizes, one per dimension when storage is NC_CHUNKED
+    std::vector<size_t> chunk_sizes;
+
+    /// Whether scale_factor and add_offset are cached, reset by attributes_changed()
+    bool packing_loaded{false};
+
+    /// Cached scale_factor attribute, 1 if absent
+    double scale_factor{1.0};
+
+    /// Cached add_offset attribute, 0 if absent
+    double add_offset{0.0};
+
+    /// Whether missing_values is cached, reset by attributes_changed() and the fill setters
+    bool missing_loaded{false};
+
+    /// Cached values treated as missing: _FillValue or the default fill, then missing_value
+    std::vector<double> missing_values;
+
+    /// Exact missing values of int64/uint64 variables, which doubles cannot hold (uint64 as bit patterns)
+    std::vector<int64_t> missing_integers;
+
+    /// Records buffered by appendRecords(), in C order
+    std::vector<uint8_t> append_buffer;
+
+    /// Record index of the first buffered record
+    size_t append_start{0};
+
+    /// Number of buffered records
+    size_t append_count{0};
 };
 
 } // namespace nodenetcdfjs
@@ -0,0 +1,71 @@
+#include "WrapperCache.h"
+#include "nodenetcdfjs.h"
+#include <mutex>
+
+namespace nodenetcdfjs
+{
+
+namespace
+{
+/// Guards the entries, which cached accessors read without holding netcdf_mutex()
+std::mutex cache_mutex;
+} // namespace
+
+std::unordered_map<int, std::map<WrapperCache::Key, v8::Global<v8::Object>>> &WrapperCache::files() noexcept
+{
+    // Deliberately leaked: destroying v8::Global handles after the isolate is gone at exit is undefined
+    static auto *entries = new std::unordered_map<int, std::map<Key, v8::Global<v8::Object>>>();
+    return *entries;
+}
+
+v8::Local<v8::Object> WrapperCache::get(v8::Isolate *isolate, Kind kind, int ncid, int id, const std::string &name)
+{
+    const int root = file_of(ncid);
+    const std::lock_guard<std::mutex> lock(cache_mutex);
+    const auto file = files().find(root);
+    if (file == files().end())
+        return {};
+    const auto entry = file->second.find(Key(static_cast<int>(kind), ncid, id, name));
+    if (entry == file->second.end())
+        return {};
+    return entry->second.Get(isolate);
+}
+
+void WrapperCache::set(v8::Isolate *isolate, Kind kind, int ncid, int id, const std::string &name,
+                       v8::Local<v8::Object> object)
+{
+    const int root = file_of(ncid);
+    const std::lock_guard<std::mutex> lock(cache_mutex);
+    v8::Global<v8::Object> &entry = files()[root][Key(static_cast<int>(kind), ncid, id, name)];
+    entry.Reset(isolate, object);
+    // Phantom weak handle: V8 clears it once the wrapper is collected, get() then reports a miss
+    entry.SetWeak();
+}
+
+void WrapperCache::erase(Kind kind, int ncid, int id, const std::string &name)
+{
+    const int root = file_of(ncid);
+    const std::lock_guard<std::mutex> lock(cache_mutex);
+    const auto file = files().find(root);
+    if (file != files().end())
+        file->second.erase(Key(static_cast<int>(kind), ncid, id, name));
+}
+
+void WrapperCache::erase_all(Kind kind, int ncid)
+{
+    const int root = file_of(ncid);
+    const std::lock_guard<std::mutex> lock(cache_mutex);
+    const auto file = files().find(root);
+    if (file == files().end())
+        return;
+    std::erase_if(file->second, [kind](const auto &entry) { return std::get<0>(entry.first) == static_cast<int>(kind); });
+}
+
+void WrapperCache::purge(int ncid)
+{
+    const int root = file_of(ncid);
+    const std::lock_guard<std::mutex> lock(cache_mutex);
+    files().erase(root);
+}
+
+} // namespace nodenetcdfjs
@@ -0,0 +1,109 @@
+#ifndef NODENETCDFJS_WRAPPERCACHE_H
+#define NODENETCDFJS_WRAPPERCACHE_H
+
+#include <map>
+#include <node.h>
+#include <node_object_wrap.h>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+
+namespace nodenetcdfjs
+{
+
+/**
+ * @brief Identity cache for the JavaScript wrappers of NetCDF objects
+ *
+ * Groups, dimensions, variables and attributes are handed out as node::ObjectWrap
+ * instances. Without a cache every property access (e.g. `group.variables`) would
+ * allocate a fresh wrapper per item. The cache keeps weak handles keyed by
+ * (kind, ncid, id, name), grouped per open file, so repeated accesses return the
+ * same JavaScript object for as long as it is reachable.
+ *
+ * Collection objects (`variables`, `dimensions`, ...) are cached the same way and
+ * must be invalidated whenever their membership or keys change. All entries of a
+ * file are purged when it is closed, since NetCDF reuses ncids.
+ *
+ * The entries have their own lock: accessors check the cache before taking
+ * netcdf_mutex(), so a hit does not wait for an asynchronous read.
+ */
+class WrapperCache
+{
+  public:
+    /// Kind of object an entry refers to
+    enum class Kind : int
+    {
+        Group,
+        Dimension,
+        Variable,
+        Attribute,
+        Variables,
+        Dimensions,
+        Unlimited,
+        Attributes,
+        Subgroups
+    };
+
+    /**
+     * @brief Look up a cached object, creating and caching it on a miss
+     * @param isolate The V8 isolate
+     * @param kind Kind of the object
+     * @param ncid Group ID the object belongs to
+     * @param id Object ID within the group (variable ID for attributes)
+     * @param name Object name, for objects identified by name
+     * @param create Called on a miss; returns the object to cache
+     * @return The cached or newly created object
+     */
+    template <typename Factory>
+    [[nodiscard]] static v8::Local<v8::Object> lookup(v8::Isolate *isolate, Kind kind, int ncid, int id,
+                                                      const std::string &name, Factory &&create)
+    {
+        v8::Local<v8::Object> cached = get(isolate, kind, ncid, id, name);
+        if (!cached.IsEmpty())
+            return cached;
+        v8::Local<v8::Object> created = create();
+        set(isolate, kind, ncid, id, name, created);
+        return created;
+    }
+
+    /**
+     * @brief Get a cached object
+     * @return The object, or an empty handle if it is not cached or was collected
+     */
+    [[nodiscard]] static v8::Local<v8::Object> get(v8::Isolate *isolate, Kind kind, int ncid, int id,
+                                                   const std::string &name = {});
+
+    /**
+     * @brief Cache an object, replacing any previous entry under the same key
+     */
+    static void set(v8::Isolate *isolate, Kind kind, int ncid, int id, const std::string &name,
+                    v8::Local<v8::Object> object);
+
+    /**
+     * @brief Drop a single entry
+     */
+    static void erase(Kind kind, int ncid, int id, const std::string &name = {});
+
+    /**
+     * @brief Drop every entry of a kind belonging to the file that contains ncid
+     *
+     * Used when a rename may have invalidated collections in any group of the file.
+     */
+    static void erase_all(Kind kind, int ncid);
+
+    /**
+     * @brief Drop every entry belonging to the file that contains ncid
+     */
+    static void purge(int ncid);
+
+  private:
+    /// Entry key: kind, group ID, object ID, object name
+    using Key = std::tuple<int, int, int, std::string>;
+
+    /// Per-file entries, keyed by the ID of the root group, see file_of()
+    [[nodiscard]] static std::unordered_map<int, std::map<Key, v8::Global<v8::Object>>> &files() noexcept;
+};
+
+} // namespace nodenetcdfjs
+
+#endif
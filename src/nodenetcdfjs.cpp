@@ -1,4 +1,5 @@
 #include "Attribute.h"
+#include "ChunkIterator.h"
 #include "Dimension.h"
 #include "File.h"
 #include "Group.h"
@@ -8,17 +9,18 @@
 
 namespace nodenetcdfjs
 {
-void InitAll(v8::Local<v8::Object> exports)
+void InitAll(v8::Local<v8::Object> exports, v8::Local<v8::Value> module)
 {
     File::Init(exports);
-    Variable::Init(exports);
+    Variable::Init(exports, module);
     Group::Init(exports);
     Dimension::Init(exports);
     Attribute::Init(exports);
+    ChunkIterator::Init(exports, module);
 }
 
 NODE_MODULE_INIT()
 {
-    InitAll(exports);
+    InitAll(exports, module);
 }
 } // namespace nodenetcdfjs
@@ -1,10 +1,12 @@
 #ifndef NODENETCDFJS_H
 #define NODENETCDFJS_H
 
+#include <mutex>
 #include <netcdf.h>
 #include <node.h>
 #include <string>
 #include <string_view>
+#include <type_traits>
 #include <unordered_map>
 
 /**
@@ -18,6 +20,21 @@
 namespace nodenetcdfjs
 {
 
+/**
+ * @brief Build a JavaScript error object from a NetCDF error code
+ * @param isolate The V8 isolate for the current JavaScript context
+ * @param retval The NetCDF error code returned from a NetCDF library function
+ * @return A v8::Exception::TypeError carrying the nc_strerror() description
+ *
+ * Used where the error has to be delivered later instead of thrown, e.g. when
+ * rejecting the Promise of an asynchronous operation.
+ */
+[[nodiscard]] inline v8::Local<v8::Value> netcdf_error(v8::Isolate *isolate, int retval)
+{
+    return v8::Exception::TypeError(
+        v8::String::NewFromUtf8(isolate, nc_strerror(retval), v8::NewStringType::kNormal).ToLocalChecked());
+}
+
 /**
  * @brief Throw a JavaScript exception with a NetCDF error message
  * @param isolate The V8 isolate for the current JavaScript context
@@ -32,8 +49,225 @@ namespace nodenetcdfjs
  */
 inline void throw_netcdf_error(v8::Isolate *isolate, int retval) noexcept(false)
 {
-    isolate->ThrowException(v8::Exception::TypeError(
-        v8::String::NewFromUtf8(isolate, nc_strerror(retval), v8::NewStringType::kNormal).ToLocalChecked()));
+    isolate->ThrowException(netcdf_error(isolate, retval));
+}
+
+/**
+ * @brief Lock serialising every call into the NetCDF library
+ * @return The process-wide recursive mutex guarding NetCDF/HDF5
+ *
+ * NetCDF and HDF5 are not thread-safe. Asynchronous operations run their I/O on
+ * the I/O thread of AsyncIO, so every call into the library - whether made from the
+ * JavaScript thread or from that thread - has to hold this lock. It is recursive
+ * because bindings call each other (e.g. toJSON() reads accessors). Accessors served
+ * from the wrapper and metadata caches take it only on a miss, so they do not wait
+ * for a running asynchronous read.
+ */
+[[nodiscard]] inline std::recursive_mutex &netcdf_mutex() noexcept
+{
+    static std::recursive_mutex mutex;
+    return mutex;
+}
+
+/**
+ * @brief Files of the groups resolved by file_of(), see forget_file()
+ */
+struct FileRoots
+{
+    /// Guards roots; file_of() is also used by accessors that do not hold netcdf_mutex()
+    std::mutex mutex;
+
+    /// Root group ID by group ID
+    std::unordered_map<int, int> roots;
+};
+
+[[nodiscard]] inline FileRoots &file_roots() noexcept
+{
+    static FileRoots roots;
+    return roots;
+}
+
+/**
+ * @brief Get the ID of the file, i.e. of the root group, holding a group
+ * @param ncid Group or file ID
+ * @return The root group ID, or ncid itself if it is not an open group
+ *
+ * Per-file registries (wrappers, mappings, asynchronous operations, appends) are keyed
+ * by it. The root is found with nc_inq_grp_parent() once per group and remembered, so
+ * later lookups do not wait for netcdf_mutex(). Callers must not hold a lock that a
+ * holder of netcdf_mutex() may wait for.
+ */
+[[nodiscard]] inline int file_of(int ncid)
+{
+    FileRoots &known = file_roots();
+    {
+        const std::lock_guard<std::mutex> lock(known.mutex);
+        if (const auto it = known.roots.find(ncid); it != known.roots.end())
+            return it->second;
+    }
+    int root = ncid;
+    {
+        const std::lock_guard<std::recursive_mutex> lock(netcdf_mutex());
+        int parent = 0;
+        int retval = NC_NOERR;
+        while ((retval = nc_inq_grp_parent(root, &parent)) == NC_NOERR)
+            root = parent;
+        // NC_ENOGRP ends the walk at the root; anything else means ncid is not open
+        if (retval != NC_ENOGRP)
+            return ncid;
+    }
+    const std::lock_guard<std::mutex> lock(known.mutex);
+    known.roots[ncid] = root;
+    return root;
+}
+
+/**
+ * @brief Forget the groups of a closed file, whose IDs NetCDF may reuse
+ * @param ncid ID of the file
+ */
+inline void forget_file(int ncid)
+{
+    FileRoots &known = file_roots();
+    const std::lock_guard<std::mutex> lock(known.mutex);
+    std::erase_if(known.roots, [ncid](const auto &entry) { return entry.second == ncid; });
+}
+
+/**
+ * @brief Wrap a method callback so it runs while holding netcdf_mutex()
+ * @tparam Callback The binding to wrap
+ * @param args JavaScript function arguments forwarded to the callback
+ */
+template <v8::FunctionCallback Callback> void serialized(const v8::FunctionCallbackInfo<v8::Value> &args)
+{
+    const std::lock_guard<std::recursive_mutex> lock(netcdf_mutex());
+    Callback(args);
+}
+
+/**
+ * @brief Wrap a property getter so it runs while holding netcdf_mutex()
+ * @tparam Getter The accessor to wrap
+ * @param property The property name being accessed
+ * @param info Callback info forwarded to the getter
+ */
+template <v8::AccessorGetterCallback Getter>
+void serialized(v8::Local<v8::String> property, const v8::PropertyCallbackInfo<v8::Value> &info)
+{
+    const std::lock_guard<std::recursive_mutex> lock(netcdf_mutex());
+    Getter(property, info);
+}
+
+/**
+ * @brief Wrap a property setter so it runs while holding netcdf_mutex()
+ * @tparam Setter The accessor to wrap
+ * @param property The property name being set
+ * @param val The new value forwarded to the setter
+ * @param info Callback info forwarded to the setter
+ */
+template <v8::AccessorSetterCallback Setter>
+void serialized(v8::Local<v8::String> property, v8::Local<v8::Value> val, const v8::PropertyCallbackInfo<void> &info)
+{
+    const std::lock_guard<std::recursive_mutex> lock(netcdf_mutex());
+    Setter(property, val, info);
+}
+
+/**
+ * @brief Look up a class of the stream built-in
+ * @param isolate The V8 isolate for the current JavaScript context
+ * @param module The addon module; addons cannot import, so its require() is used
+ * @param name Name of the class, e.g. "Readable"
+ * @return The constructor, or an empty handle if it is not available
+ */
+[[nodiscard]] inline v8::MaybeLocal<v8::Function> stream_class(v8::Isolate *isolate, v8::Local<v8::Value> module,
+                                                               const char *name)
+{
+    v8::Local<v8::Context> context = isolate->GetCurrentContext();
+    v8::Local<v8::Value> require;
+    v8::Local<v8::Value> stream;
+    v8::Local<v8::Value> result;
+    v8::Local<v8::Value> stream_name = v8::String::NewFromUtf8Literal(isolate, "stream");
+    if (module->IsObject() &&
+        module.As<v8::Object>()->Get(context, v8::String::NewFromUtf8Literal(isolate, "require")).ToLocal(&require) &&
+        require->IsFunction() && require.As<v8::Function>()->Call(context, module, 1, &stream_name).ToLocal(&stream) &&
+        stream->IsObject() &&
+        stream.As<v8::Object>()->Get(context, v8::String::NewFromUtf8(isolate, name).ToLocalChecked()).ToLocal(&result) &&
+        result->IsFunction())
+        return result.As<v8::Function>();
+    return {};
+}
+
+/**
+ * @brief Convert a BigInt or Number to a 64-bit integer
+ * @tparam T int64_t or uint64_t
+ * @param isolate The V8 isolate for the current JavaScript context
+ * @param value A BigInt (wrapped modulo 2^64 like BigInt64Array stores) or a Number (truncated)
+ * @return The converted value
+ */
+template <typename T> [[nodiscard]] inline T get_integer64(v8::Isolate *isolate, v8::Local<v8::Value> value)
+{
+    if (value->IsBigInt())
+    {
+        if constexpr (std::is_signed_v<T>)
+            return static_cast<T>(value.As<v8::BigInt>()->Int64Value());
+        else
+            return static_cast<T>(value.As<v8::BigInt>()->Uint64Value());
+    }
+    return static_cast<T>(value->IntegerValue(isolate->GetCurrentContext()).FromMaybe(0));
+}
+
+/**
+ * @brief Read a { size, nelems, preemption } chunk cache object
+ * @param isolate The V8 isolate for the current JavaScript context
+ * @param value The object; absent properties leave the corresponding output unchanged
+ * @param size Cache size in bytes
+ * @param nelems Number of hash table slots
+ * @param preemption Preemption policy between 0 and 1
+ * @return true on success; otherwise a JavaScript RangeError has been thrown
+ */
+[[nodiscard]] inline bool get_chunk_cache_options(v8::Isolate *isolate, v8::Local<v8::Object> value, size_t &size,
+                                                  size_t &nelems, float &preemption)
+{
+    v8::Local<v8::Context> context = isolate->GetCurrentContext();
+    const char *const keys[] = {"size", "nelems", "preemption"};
+    for (int i = 0; i < 3; i++)
+    {
+        v8::Local<v8::Value> field =
+            value->Get(context, v8::String::NewFromUtf8(isolate, keys[i]).ToLocalChecked()).ToLocalChecked();
+        if (field->IsUndefined())
+            continue;
+        const double number = field->NumberValue(context).FromMaybe(-1);
+        if (!(number >= 0) || (i == 2 && number > 1) || (i < 2 && number > 9.0e15))
+        {
+            const std::string message = std::string("chunkCache.") + keys[i] +
+                                        (i == 2 ? " must be between 0 and 1" : " must be a non-negative number");
+            isolate->ThrowException(v8::Exception::RangeError(
+                v8::String::NewFromUtf8(isolate, message.c_str(), v8::NewStringType::kNormal).ToLocalChecked()));
+            return false;
+        }
+        if (i == 0)
+            size = static_cast<size_t>(number);
+        else if (i == 1)
+            nelems = static_cast<size_t>(number);
+        else
+            preemption = static_cast<float>(number);
+    }
+    return true;
+}
+
+/**
+ * @brief Get the smallest prime not below a number
+ * @param n The lower bound
+ * @return The prime, as recommended by HDF5 for the number of chunk cache slots
+ */
+[[nodiscard]] constexpr size_t next_prime(size_t n) noexcept
+{
+    for (;; n++)
+    {
+        bool prime = n >= 2;
+        for (size_t f = 2; prime && f * f <= n; f++)
+            prime = n % f != 0;
+        if (prime)
+            return n;
+    }
 }
 
 /**
@@ -61,7 +295,8 @@ inline void throw_netcdf_error(v8::Isolate *isolate, int retval) noexcept(false)
 {
     constexpr std::pair<std::string_view, int> type_map[] = {
         {"byte", NC_BYTE},     {"char", NC_CHAR},   {"short", NC_SHORT},   {"int", NC_INT},   {"float", NC_FLOAT},
-        {"double", NC_DOUBLE}, {"ubyte", NC_UBYTE}, {"ushort", NC_USHORT}, {"uint", NC_UINT}, {"string", NC_STRING}};
+        {"double", NC_DOUBLE}, {"ubyte", NC_UBYTE}, {"ushort", NC_USHORT}, {"uint", NC_UINT}, {"int64", NC_INT64},
+        {"uint64", NC_UINT64}, {"string", NC_STRING}};
 
     for (const auto &[key, value] : type_map)
     {
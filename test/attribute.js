@@ -18,6 +18,19 @@ describe('Attribute', function() {
         });
     });
 
+    describe('value', function() {
+        it('should store 64-bit integer attributes as BigInt', function() {
+            var file = new nodenetcdf.File("attributes.nc", "c!", "nodenetcdf", { inMemory: true });
+            var offsets = file.root.addAttribute("offsets", "int64", new BigInt64Array([-1n, 9007199254740993n]));
+            var epoch = file.root.addAttribute("epoch", "uint64", 18446744073709551615n);
+            expect(offsets.value).to.be.instanceOf(BigInt64Array);
+            expect(Array.from(offsets.value)).to.deep.equal([-1n, 9007199254740993n]);
+            expect(epoch.value).to.equal(18446744073709551615n);
+            expect(JSON.parse(JSON.stringify(epoch)).value).to.equal("18446744073709551615");
+            file.close();
+        });
+    });
+
     describe('name', function() {
         it('should read variable attribute name', function() {
             var file = new nodenetcdf.File("test/test_hgroups.nc", "r");
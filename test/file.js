@@ -1,4 +1,7 @@
 var expect = require("chai").expect,
+    fs = require("fs"),
+    os = require("os"),
+    path = require("path"),
     nodenetcdf = require("../build/Release/nodenetcdf.node");
 
 describe('File', function() {
@@ -14,6 +17,122 @@ describe('File', function() {
                 var file = new nodenetcdf.File("test/testrh.nc", "WRONG");
             }).to.throw("Unknown file mode");
         });
+
+        it('should open a file from a Buffer', function() {
+            var buffer = fs.readFileSync("test/testrh.nc");
+            var file = new nodenetcdf.File(buffer, "r");
+            expect(Array.from(file.root.variables.var1.readSlice(0, 4))).to.deep.equal([420, 197, 391.5, 399]);
+            file.close();
+            expect(function() {
+                new nodenetcdf.File(buffer, "w");
+            }).to.throw("only be opened in mode 'r'");
+        });
+
+        it('should create a file in memory and return its bytes on close', function() {
+            var file = new nodenetcdf.File("memory.nc", "c!", "nodenetcdf", { inMemory: true });
+            var x = file.root.addDimension("x", 3);
+            file.root.addVariable("v", "short", [x.id]).writeSlice(0, 3, new Int16Array([4, 5, 6]));
+            var image = file.close();
+            expect(Buffer.isBuffer(image)).to.equal(true);
+            var reopened = new nodenetcdf.File(image, "r");
+            expect(Array.from(reopened.root.variables.v.readSlice(0, 3))).to.deep.equal([4, 5, 6]);
+            reopened.close();
+            expect(function() {
+                new nodenetcdf.File("test/testrh.nc", "r", { inMemory: true });
+            }).to.throw("needs a create mode");
+        });
+
+        it('should load a file into memory and pin its chunks', function() {
+            var filename = path.join(os.tmpdir(), "nodenetcdf-diskless-" + process.pid + ".nc");
+            var file = new nodenetcdf.File(filename, "c!", "nodenetcdf");
+            var y = file.root.addDimension("y", 3);
+            var x = file.root.addDimension("x", 4);
+            var variable = file.root.addVariable("v", "int", [y.id, x.id]);
+            variable.chunkmode = "chunked";
+            variable.chunksizes = [2, 3];
+            variable.writeSlice(0, 3, 0, 4, new Int32Array([0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11]));
+            file.close();
+            file = new nodenetcdf.File(filename, "r", { decompressOnOpen: { maxBytes: 4 * 2 * 3 * 4 - 1 } });
+            expect(file.root.variables.v.chunkCache.preemption).to.not.equal(0);
+            file.close();
+            file = new nodenetcdf.File(filename, "r", { diskless: true, decompressOnOpen: true });
+            fs.unlinkSync(filename);
+            variable = file.root.variables.v;
+            expect(variable.chunkCache.size).to.equal(4 * 2 * 3 * 4);
+            expect(variable.chunkCache.preemption).to.equal(0);
+            expect(Array.from(variable.readSlice(1, 2, 2, 2))).to.deep.equal([6, 7, 10, 11]);
+            file.close();
+            expect(function() {
+                new nodenetcdf.File("test/testrh.nc", "w", { diskless: true });
+            }).to.throw("diskless needs mode 'r'");
+            expect(function() {
+                new nodenetcdf.File("test/testrh.nc", "w", { decompressOnOpen: true });
+            }).to.throw("decompressOnOpen needs mode 'r'");
+            expect(function() {
+                new nodenetcdf.File("test/testrh.nc", "r", { decompressOnOpen: { maxBytes: -1 } });
+            }).to.throw("maxBytes must be a non-negative number");
+        });
+
+        it('should read contiguous slices of a classic file from a memory mapping', function() {
+            var file = new nodenetcdf.File("test/testrh.nc", "r", { mmap: true });
+            var values = file.root.variables.var1.readSlice(0, 4);
+            expect(Array.from(values)).to.deep.equal([420, 197, 391.5, 399]);
+            values[0] = 0;
+            expect(Array.from(file.root.variables.var1.readSlice(0, 1))).to.deep.equal([420]);
+            expect(Array.from(file.root.variables.var1.readSlice(1, 2, { outputType: "double" }))).to.deep.equal([197, 391.5]);
+            file.close();
+            expect(values[1]).to.equal(197);
+            expect(function() {
+                new nodenetcdf.File("test/testrh.nc", "w", { mmap: true });
+            }).to.throw("mmap needs mode 'r'");
+        });
+
+        it('should give each zero-copy view of a mapping its own pages', function() {
+            var filename = path.join(os.tmpdir(), "nodenetcdf-mmap-" + process.pid + ".nc");
+            var file = new nodenetcdf.File(filename, "c!", "classic");
+            var x = file.root.addDimension("x", 4);
+            file.root.addVariable("b", "byte", [x.id]);
+            file.close();
+            file = new nodenetcdf.File(filename, "w");
+            file.root.variables.b.writeSlice(0, 4, new Int8Array([1, 2, 3, 4]));
+            file.close();
+            file = new nodenetcdf.File(filename, "r", { mmap: true });
+            var first = file.root.variables.b.readSlice(0, 4);
+            var second = file.root.variables.b.readSlice(0, 4);
+            first[0] = 100;
+            expect(Array.from(second)).to.deep.equal([1, 2, 3, 4]);
+            expect(Array.from(file.root.variables.b.readSlice(0, 4))).to.deep.equal([1, 2, 3, 4]);
+            file.close();
+            expect(Array.from(first)).to.deep.equal([100, 2, 3, 4]);
+            fs.unlinkSync(filename);
+        });
+
+        it('should create a CDF5 file with unsigned types', function() {
+            var filename = path.join(os.tmpdir(), "nodenetcdf-cdf5-" + process.pid + ".nc");
+            var file = new nodenetcdf.File(filename, "c!", "cdf5");
+            var x = file.root.addDimension("x", 3);
+            file.root.addVariable("u", "uint", [x.id]);
+            file.root.addVariable("b", "ubyte", [x.id]);
+            file.close();
+            file = new nodenetcdf.File(filename, "w");
+            file.root.variables.u.writeSlice(0, 3, new Uint32Array([1, 4000000000, 3]));
+            file.root.variables.b.writeSlice(0, 3, new Uint8Array([7, 200, 9]));
+            file.close();
+            file = new nodenetcdf.File(filename, "r", { mmap: true });
+            expect(Array.from(file.root.variables.u.readSlice(0, 3))).to.deep.equal([1, 4000000000, 3]);
+            expect(Array.from(file.root.variables.b.readSlice(1, 2))).to.deep.equal([200, 9]);
+            file.close();
+            fs.unlinkSync(filename);
+        });
+
+        it('should accept a chunk cache in the open options', function() {
+            var file = new nodenetcdf.File("test/testrh.nc", "r", { chunkCache: { size: 1 << 20, nelems: 521 } });
+            expect(Array.from(file.root.variables.var1.readSlice(0, 1))).to.deep.equal([420]);
+            file.close();
+            expect(function() {
+                new nodenetcdf.File("test/testrh.nc", "r", { chunkCache: { preemption: 2 } });
+            }).to.throw("between 0 and 1");
+        });
     });
 
 });
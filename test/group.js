@@ -1,4 +1,7 @@
 var expect = require("chai").expect,
+    os = require("os"),
+    path = require("path"),
+    fs = require("fs"),
     nodenetcdf = require("../build/Release/nodenetcdf.node");
 
 describe('Group', function() {
@@ -54,4 +57,73 @@ describe('Group', function() {
             expect(file.root.name).to.equal("/");
         });
     });
+
+    describe('readSlices', function() {
+        it('should read several slices in one call', function() {
+            var file = new nodenetcdf.File("test/testrh.nc", "r");
+            var variable = file.root.variables.var1;
+            var results = file.root.readSlices([
+                {variable: "var1", start: [2], count: [2]},
+                {variable: variable, start: [0], count: [2], stride: [2]}
+            ]);
+            expect(Array.from(results[0])).to.deep.equal([391.5, 399]);
+            expect(Array.from(results[1])).to.deep.equal([420, 391.5]);
+        });
+
+        it('should pack results into one buffer', function() {
+            var file = new nodenetcdf.File("test/testrh.nc", "r");
+            var results = file.root.readSlices([
+                {variable: "var1", start: [0], count: [1]},
+                {variable: "var1", start: [1], count: [3]}
+            ], {pack: true});
+            expect(results[0].buffer).to.equal(results[1].buffer);
+            expect(results[1].byteOffset).to.equal(8);
+            expect(Array.from(results[1])).to.deep.equal([197, 391.5, 399]);
+        });
+    });
+
+    describe('get', function() {
+        it('should resolve variables and groups by path', function() {
+            var file = new nodenetcdf.File("test/test_hgroups.nc", "r");
+            var flight = "mozaic_flight_2012030419144751_ascent";
+            var variable = file.get("/" + flight + "/air_press");
+            expect(variable.name).to.equal("air_press");
+            expect(variable).to.equal(file.root.subgroups[flight].variables.air_press);
+            expect(file.get(flight).name).to.equal(flight);
+            expect(file.get("/")).to.equal(file.root);
+            expect(file.root.get(flight + "/air_press")).to.equal(variable);
+            expect(file.get(flight).get("/UTC_time")).to.equal(file.root.variables.UTC_time);
+            expect(file.root.getVariable("UTC_time")).to.equal(file.root.variables.UTC_time);
+            expect(file.root.getVariable("missing")).to.equal(undefined);
+            expect(file.get("/missing/air_press")).to.equal(undefined);
+            file.close();
+        });
+    });
+
+    describe('wrapper identity', function() {
+        it('should return the same wrappers on repeated access', function() {
+            var file = new nodenetcdf.File("test/test_hgroups.nc", "r");
+            expect(file.root.variables).to.equal(file.root.variables);
+            expect(file.root.variables.UTC_time).to.equal(file.root.variables.UTC_time);
+            expect(file.root.dimensions.recNum).to.equal(file.root.variables.UTC_time.dimensions[0]);
+            file.close();
+        });
+
+        it('should refresh collections after they change', function() {
+            var filename = path.join(os.tmpdir(), "nodenetcdf-identity-" + process.pid + ".nc");
+            var file = new nodenetcdf.File(filename, "c!", "nodenetcdf");
+            var x = file.root.addDimension("x", 3);
+            var before = file.root.variables;
+            var variable = file.root.addVariable("v", "int", [x.id]);
+            expect(before).to.not.have.property("v");
+            expect(file.root.variables.v).to.equal(variable);
+            variable.name = "w";
+            expect(file.root.variables).to.not.have.property("v");
+            expect(file.root.variables.w).to.equal(variable);
+            x.name = "y";
+            expect(file.root.dimensions.y).to.equal(x);
+            file.close();
+            fs.unlinkSync(filename);
+        });
+    });
 });
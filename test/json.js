@@ -107,7 +107,7 @@ describe('JSON Serialization', function() {
             expect(json).to.be.an('object');
             expect(json).to.have.property('id');
             expect(json).to.have.property('name', 'var1');
-            expect(json).to.have.property('type', 'double');
+            expect(json).to.have.property('type', 'float');
         });
         
         it('should have all required properties in JSON', function() {
@@ -174,5 +174,20 @@ describe('JSON Serialization', function() {
             expect(json.attributes).to.be.an('array');
             expect(json.subgroups).to.be.an('array');
         });
+
+        it('should describe the file natively, as objects or JSON text', function() {
+            var tree = file.describe();
+            var json = JSON.parse(JSON.stringify(file));
+            expect(tree.fullname).to.equal(json.fullname);
+            expect(tree.variables.map(function(v) { return v.name; }))
+                .to.deep.equal(json.variables.map(function(v) { return v.name; }));
+            expect(tree.attributes).to.deep.equal(json.attributes);
+            var var1 = tree.variables.filter(function(v) { return v.name === 'var1'; })[0];
+            expect(var1.type).to.equal('float');
+            expect(var1.dimensions[0]).to.include({ name: 'dim1', length: 10000 });
+            expect(var1).to.have.property('chunkmode');
+            expect(var1).to.have.property('fillvalue');
+            expect(JSON.parse(file.describe({ json: true }))).to.deep.equal(tree);
+        });
     });
 });
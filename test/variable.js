@@ -1,4 +1,7 @@
 var expect = require("chai").expect,
+    os = require("os"),
+    path = require("path"),
+    fs = require("fs"),
     nodenetcdf = require("../build/Release/nodenetcdf.node");
 
 describe('Variable', function() {
@@ -13,4 +16,449 @@ describe('Variable', function() {
       var results = Array.from(file.root.variables.var1.readStridedSlice(0, 2, 2));
         expect(results).to.deep.equal([420, 391.5]);
   });
-});
\ No newline at end of file
+
+  it('should convert a slice to the requested output type', function() {
+      var file = new nodenetcdf.File("test/testrh.nc", "r");
+      var variable = file.root.variables.var1;
+      var doubles = variable.readSlice(0, 4, { outputType: "double" });
+      expect(doubles).to.be.instanceOf(Float64Array);
+      expect(Array.from(doubles)).to.deep.equal([420, 197, 391.5, 399]);
+      var ints = variable.readStridedSlice(0, 2, 2, { outputType: "int" });
+      expect(ints).to.be.instanceOf(Int32Array);
+      expect(Array.from(ints)).to.deep.equal([420, 391]);
+      expect(function() {
+          variable.readSlice(0, 4, { outputType: "string" });
+      }).to.throw("Unknown outputType");
+  });
+
+  it('should unpack scale_factor and add_offset while reading', function() {
+      var filename = path.join(os.tmpdir(), "nodenetcdf-unpack-" + process.pid + ".nc");
+      var file = new nodenetcdf.File(filename, "c!", "nodenetcdf");
+      var x = file.root.addDimension("x", 3);
+      var variable = file.root.addVariable("v", "short", [x.id]);
+      variable.writeSlice(0, 3, new Int16Array([0, 10, -4]));
+      variable.addAttribute("scale_factor", "double", 0.5);
+      variable.addAttribute("add_offset", "double", 100);
+      var unpacked = variable.readSlice(0, 3, { unpack: true });
+      expect(unpacked).to.be.instanceOf(Float32Array);
+      expect(Array.from(unpacked)).to.deep.equal([100, 105, 98]);
+      variable.attributes.add_offset.value = 1;
+      var doubles = variable.readStridedSlice(0, 2, 2, { unpack: true, outputType: "double" });
+      expect(doubles).to.be.instanceOf(Float64Array);
+      expect(Array.from(doubles)).to.deep.equal([1, -1]);
+      file.close();
+      fs.unlinkSync(filename);
+  });
+
+  it('should mask fill and missing values while reading', function() {
+      var filename = path.join(os.tmpdir(), "nodenetcdf-mask-" + process.pid + ".nc");
+      var file = new nodenetcdf.File(filename, "c!", "nodenetcdf");
+      var x = file.root.addDimension("x", 4);
+      var variable = file.root.addVariable("v", "short", [x.id]);
+      variable.addAttribute("missing_value", "short", 5);
+      variable.writeSlice(0, 3, new Int16Array([1, 5, 2]));
+      var masked = variable.readSlice(0, 4, { mask: true, outputType: "float" });
+      expect(Array.from(masked)).to.deep.equal([1, NaN, 2, NaN]);
+      var result = variable.readSlice(0, 4, { mask: "bitmap" });
+      expect(result.values).to.be.instanceOf(Int16Array);
+      expect(Array.from(result.validity)).to.deep.equal([5]);
+      expect(function() {
+          variable.readSlice(0, 4, { mask: true });
+      }).to.throw("mask 'bitmap'");
+      file.close();
+      fs.unlinkSync(filename);
+  });
+
+  it('should read and write 64-bit integers as BigInt', function() {
+      var filename = path.join(os.tmpdir(), "nodenetcdf-int64-" + process.pid + ".nc");
+      var file = new nodenetcdf.File(filename, "c!", "nodenetcdf");
+      var x = file.root.addDimension("x", 3);
+      var time = file.root.addVariable("time", "int64", [x.id]);
+      var count = file.root.addVariable("count", "uint64", [x.id]);
+      time.writeSlice(0, 2, new BigInt64Array([1700000000000000001n, -5n]));
+      time.write(2, 9007199254740993n);
+      count.writeSlice(0, 3, new BigUint64Array([18446744073709551615n, 0n, 1n]));
+      expect(time.type).to.equal("int64");
+      expect(Array.from(time.readSlice(0, 3))).to.deep.equal([1700000000000000001n, -5n, 9007199254740993n]);
+      expect(time.read(2)).to.equal(9007199254740993n);
+      expect(count.readSlice(0, 3)).to.be.instanceOf(BigUint64Array);
+      expect(count.read(0)).to.equal(18446744073709551615n);
+      expect(Array.from(time.readSlice(1, 1, { outputType: "double" }))).to.deep.equal([-5]);
+      expect(Array.from(time.readSlice(0, 3, { mask: "bitmap" }).validity)).to.deep.equal([7]);
+      expect(function() {
+          time.writeSlice(0, 3, new Float64Array(3));
+      }).to.throw("expected BigInt64Array");
+      file.close();
+      fs.unlinkSync(filename);
+  });
+
+  it('should read char rows as UTF-8 data and offsets', function() {
+      var filename = path.join(os.tmpdir(), "nodenetcdf-strings-" + process.pid + ".nc");
+      var file = new nodenetcdf.File(filename, "c!", "nodenetcdf");
+      var station = file.root.addDimension("station", 3);
+      var len = file.root.addDimension("len", 8);
+      var ids = file.root.addVariable("ids", "char", [station.id, len.id]);
+      var rows = Buffer.alloc(24);
+      rows.write("ABC", 0);
+      rows.write("DEFG    ", 8);
+      rows.write("HIJKLMNO", 16);
+      ids.writeSlice(0, 3, 0, 8, new Int8Array(rows.buffer, rows.byteOffset, 24));
+      var result = ids.readStrings(1, 2);
+      expect(Array.from(result.offsets)).to.deep.equal([0, 4, 12]);
+      expect(Buffer.from(result.data).toString()).to.equal("DEFGHIJKLMNO");
+      expect(Array.from(ids.readStrings(0, 3).offsets)).to.deep.equal([0, 3, 7, 15]);
+      expect(function() {
+          file.root.addVariable("n", "int", [station.id]).readStrings(0, 3);
+      }).to.throw("not string or char");
+      file.close();
+      fs.unlinkSync(filename);
+  });
+
+  it('should read a slice into a supplied typed array', function() {
+      var file = new nodenetcdf.File("test/testrh.nc", "r");
+      var target = new Float32Array(6);
+      var result = file.root.variables.var1.readSliceInto(0, 4, target, 8);
+      expect(result).to.equal(target);
+      expect(Array.from(target)).to.deep.equal([0, 0, 420, 197, 391.5, 399]);
+      file.root.variables.var1.readStridedSliceInto(0, 2, 2, target);
+      expect(Array.from(target.subarray(0, 2))).to.deep.equal([420, 391.5]);
+  });
+
+  it('should reject a mismatched readSliceInto target', function() {
+      var file = new nodenetcdf.File("test/testrh.nc", "r");
+      var variable = file.root.variables.var1;
+      expect(function() {
+          variable.readSliceInto(0, 4, new Float64Array(4));
+      }).to.throw("Target type mismatch");
+      expect(function() {
+          variable.readSliceInto(0, 4, new Float32Array(4), 4);
+      }).to.throw("Target too small");
+  });
+
+  it('should read scattered points', function() {
+      var file = new nodenetcdf.File("test/testrh.nc", "r");
+      var variable = file.root.variables.var1;
+      expect(Array.from(variable.readPoints(new Int32Array([3, 0, 2, 0])))).to.deep.equal([399, 420, 391.5, 420]);
+      expect(Array.from(variable.readPoints(new BigUint64Array([1n])))).to.deep.equal([197]);
+      expect(function() {
+          variable.readPoints(new Int32Array([-1]));
+      }).to.throw("out of bounds");
+      expect(function() {
+          variable.readPoints(new BigInt64Array([0n, 2n, -1n]));
+      }).to.throw("Point 2 is out of bounds in dimension 0");
+  });
+
+  it('should write scattered points', function() {
+      var filename = path.join(os.tmpdir(), "nodenetcdf-points-" + process.pid + ".nc");
+      var file = new nodenetcdf.File(filename, "c!", "nodenetcdf");
+      var y = file.root.addDimension("y", 4);
+      var x = file.root.addDimension("x", 5);
+      var variable = file.root.addVariable("v", "short", [y.id, x.id]);
+      variable.chunkmode = "chunked";
+      variable.chunksizes = [2, 2];
+      variable.writeSlice(0, 4, 0, 5, new Int16Array(20));
+      variable.writePoints(new Int32Array([3, 4, 0, 0, 0, 1, 3, 4]), new Int16Array([1, 2, 3, 4]));
+      expect(Array.from(variable.readSlice(0, 1, 0, 2))).to.deep.equal([2, 3]);
+      expect(Array.from(variable.readPoints(new Int32Array([3, 4, 2, 2])))).to.deep.equal([4, 0]);
+      expect(function() {
+          variable.writePoints(new Int32Array([0, 0]), new Int32Array([1]));
+      }).to.throw("Int16Array");
+      file.close();
+      fs.unlinkSync(filename);
+  });
+
+  it('should buffer appended records until a chunk is full', function() {
+      var filename = path.join(os.tmpdir(), "nodenetcdf-append-" + process.pid + ".nc");
+      var file = new nodenetcdf.File(filename, "c!", "nodenetcdf");
+      var t = file.root.addDimension("t", 0);
+      var x = file.root.addDimension("x", 2);
+      var variable = file.root.addVariable("v", "int", [t.id, x.id]);
+      variable.chunkmode = "chunked";
+      variable.chunksizes = [4, 2];
+      variable.appendRecords(new Int32Array([0, 1, 2, 3, 4, 5]));
+      expect(t.length).to.equal(0);
+      variable.appendRecords(new Int32Array([6, 7, 8, 9]));
+      expect(t.length).to.equal(4);
+      expect(file.describe().dimensions[0]).to.include({ name: "t", length: 4, bufferedLength: 5 });
+      expect(t.length).to.equal(4);
+      file.sync();
+      expect(t.length).to.equal(5);
+      expect(Array.from(variable.readSlice(0, 5, 0, 2))).to.deep.equal([0, 1, 2, 3, 4, 5, 6, 7, 8, 9]);
+      expect(function() {
+          variable.appendRecords(new Int32Array(3));
+      }).to.throw("multiple of the record size");
+      expect(function() {
+          file.root.addVariable("w", "int", [x.id]).appendRecords(new Int32Array(2));
+      }).to.throw("must be unlimited");
+      variable.appendRecords(new Int32Array([10, 11]));
+      file.close();
+      file = new nodenetcdf.File(filename, "r");
+      expect(file.root.dimensions.t.length).to.equal(6);
+      file.close();
+      fs.unlinkSync(filename);
+  });
+
+  it('should append records written to an append stream', async function() {
+      var filename = path.join(os.tmpdir(), "nodenetcdf-appendstream-" + process.pid + ".nc");
+      var file = new nodenetcdf.File(filename, "c!", "nodenetcdf");
+      var t = file.root.addDimension("t", 0);
+      var x = file.root.addDimension("x", 2);
+      var variable = file.root.addVariable("v", "int", [t.id, x.id]);
+      variable.chunkmode = "chunked";
+      variable.chunksizes = [4, 2];
+      var stream = variable.createAppendStream();
+      stream.write(new Int32Array([0, 1, 2, 3, 4, 5]));
+      stream.write(new Int32Array([6, 7]));
+      await new Promise(function(resolve) {
+          stream.end(new Int32Array([8, 9]), resolve);
+      });
+      expect(t.length).to.equal(5);
+      expect(Array.from(variable.readSlice(0, 5, 0, 2))).to.deep.equal([0, 1, 2, 3, 4, 5, 6, 7, 8, 9]);
+      var failed = variable.createAppendStream();
+      var error = await new Promise(function(resolve) {
+          failed.on("error", resolve);
+          failed.write(new Float32Array(2));
+      });
+      expect(error.message).to.contain("Int32Array");
+      expect(function() {
+          file.root.addVariable("w", "int", [x.id]).createAppendStream();
+      }).to.throw("must be unlimited");
+      file.close();
+      fs.unlinkSync(filename);
+  });
+
+  it('should keep appended records of variables sharing a dimension aligned', function() {
+      var filename = path.join(os.tmpdir(), "nodenetcdf-append2-" + process.pid + ".nc");
+      var file = new nodenetcdf.File(filename, "c!", "nodenetcdf");
+      var t = file.root.addDimension("t", 0);
+      var a = file.root.addVariable("a", "int", [t.id]);
+      var b = file.root.addVariable("b", "int", [t.id]);
+      a.chunkmode = "chunked";
+      a.chunksizes = [4];
+      b.chunkmode = "chunked";
+      b.chunksizes = [1];
+      for (var i = 0; i < 6; i++) {
+          b.appendRecords(new Int32Array([10 + i]));
+          a.appendRecords(new Int32Array([i]));
+      }
+      file.sync();
+      expect(t.length).to.equal(6);
+      expect(Array.from(a.readSlice(0, 6))).to.deep.equal([0, 1, 2, 3, 4, 5]);
+      expect(Array.from(b.readSlice(0, 6))).to.deep.equal([10, 11, 12, 13, 14, 15]);
+      // Records written by writeSlice() in between are not overwritten by later appends
+      a.writeSlice(6, 2, new Int32Array([6, 7]));
+      var c = file.root.addVariable("c", "int", [t.id]);
+      c.appendRecords(new Int32Array([20]));
+      a.appendRecords(new Int32Array([8]));
+      file.sync();
+      expect(t.length).to.equal(9);
+      expect(Array.from(a.readSlice(6, 3))).to.deep.equal([6, 7, 8]);
+      expect(Array.from(c.readSlice(8, 1))).to.deep.equal([20]);
+      file.close();
+      fs.unlinkSync(filename);
+  });
+
+  it('should read user-defined types as columns', function() {
+      var file = new nodenetcdf.File("test/usertypes.nc", "r");
+      var variables = file.root.variables;
+      expect(variables.obs.type).to.equal("obs_t");
+      var obs = variables.obs.readSlice(0, 3);
+      expect(obs.time).to.be.instanceOf(Int32Array);
+      expect(Array.from(obs.time)).to.deep.equal([10, 20, 30]);
+      expect(obs.pos).to.be.instanceOf(Float32Array);
+      expect(Array.from(obs.pos)).to.deep.equal([0.5, 1.5, 2.5, 3.5, 4.5, 5.5]);
+      expect(Array.from(obs.value)).to.deep.equal([2.25, 4.5, 6.75]);
+      expect(Array.from(variables.obs.readSlice(1, 1).pos)).to.deep.equal([2.5, 3.5]);
+      var cloud = variables.cloud.readSlice(0, 3);
+      expect(cloud).to.be.instanceOf(Uint8Array);
+      expect(Array.from(cloud)).to.deep.equal([0, 2, 1]);
+      var ragged = variables.ragged.readSlice(0, 3);
+      expect(ragged.values).to.be.instanceOf(Int16Array);
+      expect(Array.from(ragged.values)).to.deep.equal([1, 2, 3, 4, 5]);
+      expect(Array.from(ragged.offsets)).to.deep.equal([0, 2, 2, 5]);
+      var blob = variables.blob.readSlice(1, 2);
+      expect(blob).to.be.instanceOf(Uint8Array);
+      expect(Array.from(blob)).to.deep.equal([5, 6, 7, 8, 9, 10, 11, 12]);
+      expect(function() {
+          variables.obs.readSlice(0, 3, { outputType: "double" });
+      }).to.throw("not supported for user-defined type obs_t");
+      file.close();
+  });
+
+  it('should set and auto-size the chunk cache', function() {
+      var filename = path.join(os.tmpdir(), "nodenetcdf-cache-" + process.pid + ".nc");
+      var file = new nodenetcdf.File(filename, "c!", "nodenetcdf");
+      var t = file.root.addDimension("t", 10);
+      var y = file.root.addDimension("y", 8);
+      var variable = file.root.addVariable("v", "float", [t.id, y.id]);
+      variable.chunkmode = "chunked";
+      variable.chunksizes = [1, 8];
+      variable.chunkCache = { size: 65536, nelems: 131, preemption: 0.5 };
+      expect(variable.chunkCache).to.deep.equal({ size: 65536, nelems: 131, preemption: 0.5 });
+      variable.chunkCache = { access: [10, 1] };
+      var cache = variable.chunkCache;
+      expect(cache.size).to.equal(10 * 8 * 4);
+      expect(cache.nelems).to.equal(1009);
+      expect(cache.preemption).to.equal(0.5);
+      expect(function() {
+          variable.chunkCache = { access: [1] };
+      }).to.throw("one extent per dimension");
+      file.close();
+      fs.unlinkSync(filename);
+  });
+
+  it('should reduce a slice natively', function() {
+      var file = new nodenetcdf.File("test/testrh.nc", "r");
+      var stats = file.root.variables.var1.reduce({ start: [0], count: [4] });
+      expect(stats.shape).to.deep.equal([]);
+      expect(Array.from(stats.min)).to.deep.equal([197]);
+      expect(Array.from(stats.max)).to.deep.equal([420]);
+      expect(Array.from(stats.mean)).to.deep.equal([351.875]);
+      expect(Array.from(stats.count)).to.deep.equal([4]);
+      file.close();
+  });
+
+  it('should reduce along selected axes and skip missing values', function() {
+      var filename = path.join(os.tmpdir(), "nodenetcdf-reduce-" + process.pid + ".nc");
+      var file = new nodenetcdf.File(filename, "c!", "nodenetcdf");
+      var y = file.root.addDimension("y", 2);
+      var x = file.root.addDimension("x", 3);
+      var variable = file.root.addVariable("v", "int", [y.id, x.id]);
+      variable.chunkmode = "chunked";
+      variable.chunksizes = [1, 2];
+      variable.addAttribute("missing_value", "int", -1);
+      variable.writeSlice(0, 2, 0, 3, new Int32Array([1, 2, -1, 4, 5, 6]));
+      var rows = variable.reduce({ ops: ["sum", "count"], axes: [1] });
+      expect(rows.shape).to.deep.equal([2]);
+      expect(Array.from(rows.sum)).to.deep.equal([3, 15]);
+      expect(Array.from(rows.count)).to.deep.equal([2, 3]);
+      expect(rows.min).to.equal(undefined);
+      var cols = variable.reduce({ start: [0, 1], count: [2, 2], ops: ["max"], axes: [0] });
+      expect(Array.from(cols.max)).to.deep.equal([5, 6]);
+      file.close();
+      fs.unlinkSync(filename);
+  });
+
+  it('should iterate over chunk-aligned blocks', async function() {
+      var filename = path.join(os.tmpdir(), "nodenetcdf-chunks-" + process.pid + ".nc");
+      var file = new nodenetcdf.File(filename, "c!", "nodenetcdf");
+      var y = file.root.addDimension("y", 3);
+      var x = file.root.addDimension("x", 4);
+      var variable = file.root.addVariable("v", "int", [y.id, x.id]);
+      variable.chunkmode = "chunked";
+      variable.chunksizes = [2, 2];
+      variable.writeSlice(0, 3, 0, 4, new Int32Array([0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11]));
+      var blocks = [];
+      for await (var block of variable.chunks({ start: [1, 1], count: [2, 3], maxBytes: 16 })) {
+          blocks.push([block.start, block.count, Array.from(block.data)]);
+      }
+      expect(blocks).to.deep.equal([
+          [[1, 1], [1, 1], [5]],
+          [[1, 2], [1, 2], [6, 7]],
+          [[2, 1], [1, 1], [9]],
+          [[2, 2], [1, 2], [10, 11]]
+      ]);
+      var whole = [];
+      for await (var block of variable.chunks()) {
+          whole.push(block.count);
+      }
+      expect(whole).to.deep.equal([[3, 4]]);
+      file.close();
+      fs.unlinkSync(filename);
+  });
+
+  it('should stream a slice as Buffers in C order', async function() {
+      var filename = path.join(os.tmpdir(), "nodenetcdf-stream-" + process.pid + ".nc");
+      var file = new nodenetcdf.File(filename, "c!", "nodenetcdf");
+      var y = file.root.addDimension("y", 3);
+      var x = file.root.addDimension("x", 4);
+      var variable = file.root.addVariable("v", "int", [y.id, x.id]);
+      variable.writeSlice(0, 3, 0, 4, new Int32Array([0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11]));
+      var chunks = [];
+      for await (var chunk of variable.createReadStream({ highWaterMark: 16 })) {
+          expect(Buffer.isBuffer(chunk)).to.equal(true);
+          chunks.push(chunk);
+      }
+      expect(chunks.length).to.equal(3);
+      var bytes = Buffer.concat(chunks);
+      expect(Array.from(new Int32Array(bytes.buffer, bytes.byteOffset, 12))).to.deep.equal([0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11]);
+      chunks = [];
+      for await (var chunk of variable.createReadStream({ start: [1, 1], count: [2, 3] })) {
+          chunks.push(chunk);
+      }
+      bytes = Buffer.concat(chunks);
+      expect(Array.from(new Int32Array(bytes.buffer, bytes.byteOffset, 6))).to.deep.equal([5, 6, 7, 9, 10, 11]);
+      file.close();
+      fs.unlinkSync(filename);
+  });
+
+  it('should read a slice asynchronously', function() {
+      var file = new nodenetcdf.File("test/testrh.nc", "r");
+      return file.root.variables.var1.readSliceAsync(0, 4).then(function(results) {
+          expect(results).to.be.instanceOf(Float32Array);
+          expect(Array.from(results)).to.deep.equal([420, 197, 391.5, 399]);
+      });
+  });
+
+  it('should refuse to close a file while a read is in flight', async function() {
+      var file = new nodenetcdf.File("test/testrh.nc", "r");
+      var pending = file.root.variables.var1.readSliceAsync(0, 4);
+      expect(function() {
+          file.close();
+      }).to.throw("still running");
+      expect(Array.from(await pending)).to.deep.equal([420, 197, 391.5, 399]);
+      file.close();
+  });
+
+  it('should serve cached properties and complete reads queued back to back', async function() {
+      var file = new nodenetcdf.File("test/testrh.nc", "r");
+      var variables = file.root.variables;
+      var var1 = variables.var1;
+      var reads = [var1.readSliceAsync(0, 4), var1.readSliceAsync(0, 2), var1.readStridedSliceAsync(0, 2, 2)];
+      expect(file.root.variables).to.equal(variables);
+      expect(var1.name).to.equal("var1");
+      expect(var1.dimensions[0]).to.equal(var1.dimensions[0]);
+      expect(var1.attributes).to.equal(var1.attributes);
+      var results = await Promise.all(reads);
+      expect(Array.from(results[0])).to.deep.equal([420, 197, 391.5, 399]);
+      expect(Array.from(results[1])).to.deep.equal([420, 197]);
+      expect(Array.from(results[2])).to.deep.equal([420, 391.5]);
+      file.close();
+  });
+
+  it('should write and read back a slice asynchronously', function() {
+      var filename = path.join(os.tmpdir(), "nodenetcdf-async-" + process.pid + ".nc");
+      var file = new nodenetcdf.File(filename, "c!", "nodenetcdf");
+      var x = file.root.addDimension("x", 6);
+      var variable = file.root.addVariable("v", "int", [x.id]);
+      return variable.writeSliceAsync(1, 4, new Int32Array([7, 8, 9, 10]))
+          .then(function() {
+              return variable.readStridedSliceAsync(1, 2, 2);
+          })
+          .then(function(results) {
+              expect(Array.from(results)).to.deep.equal([7, 9]);
+              file.close();
+              fs.unlinkSync(filename);
+          });
+  });
+
+  it('should keep cached metadata in sync with rename and chunking changes', function() {
+      var filename = path.join(os.tmpdir(), "nodenetcdf-meta-" + process.pid + ".nc");
+      var file = new nodenetcdf.File(filename, "c!", "nodenetcdf");
+      var t = file.root.addDimension("t", 0);
+      var x = file.root.addDimension("x", 6);
+      var variable = file.root.addVariable("v", "int", [t.id, x.id]);
+      variable.chunkmode = "chunked";
+      variable.chunksizes = [1, 3];
+      expect(variable.chunkmode).to.equal("chunked");
+      expect(variable.chunksizes).to.deep.equal([1, 3]);
+      variable.name = "w";
+      expect(variable.name).to.equal("w");
+      expect(variable.dimensions.map(function(d) { return d.name; })).to.deep.equal(["t", "x"]);
+      expect(function() {
+          variable.readSlice(0, 1);
+      }).to.throw("for 'w'");
+      file.close();
+      fs.unlinkSync(filename);
+  });
+});